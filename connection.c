@@ -17,7 +17,9 @@
 #if PG_VERSION_NUM >= 130000
 #include "common/hashfn.h"
 #endif
+#include "lib/ilist.h"
 #include "mb/pg_wchar.h"
+#include "miscadmin.h"
 #include "mysql_fdw.h"
 #include "mysql/errmsg.h"
 #include "utils/hsearch.h"
@@ -29,9 +31,11 @@
 #include "funcapi.h"
 #include "utils/builtins.h"
 #include "utils/datetime.h"
-#include "miscadmin.h"
 #endif
 #include "commands/defrem.h"
+#include "pgstat.h"
+#include "storage/latch.h"
+#include "utils/timestamp.h"
 
 /* Length of host */
 #define HOST_LEN 256
@@ -40,13 +44,19 @@
  * Connection cache hash table entry
  *
  * The lookup key in this hash table is the foreign server OID plus the user
- * mapping OID.  (We use just one connection per user per foreign server,
- * so that we can ensure all scans use the same snapshot during a query.)
+ * mapping OID, plus a replica number and a slot number.  Replica 0 is the
+ * server itself, the primary, and the others its read replicas, in the order
+ * of the replicas option.  Slot 0 is the connection shared by all scans and
+ * modifications of the user on the primary or replica, so that they all use
+ * the same remote transaction.  The other slots pool the private
+ * connections that stream scans take for themselves while they run.
  */
 typedef struct ConnCacheKey
 {
 	Oid			serverid;		/* OID of foreign server */
 	Oid			userid;			/* OID of local user whose mapping we use */
+	int			replica;		/* 0 for the primary, else replica index + 1 */
+	int			slot;			/* 0 for the shared connection */
 } ConnCacheKey;
 
 typedef struct ConnCacheEntry
@@ -54,6 +64,7 @@ typedef struct ConnCacheEntry
 	ConnCacheKey key;			/* hash key (must be first) */
 	MYSQL	   *conn;			/* connection to foreign server, or NULL */
 	bool		invalidated;	/* true if reconnect is pending */
+	bool		in_use;			/* private connection taken by a scan? */
 	uint32		server_hashvalue;	/* hash value of foreign server OID */
 	uint32		mapping_hashvalue;	/* hash value of user mapping OID */
 	int			xact_depth;		/* 0 = no xact open, 1 = main xact open, 2 =
@@ -61,9 +72,61 @@ typedef struct ConnCacheEntry
 
 	bool		keep_connections;	/* setting value of keep_connections
 									 * server option */
+	bool		parallel_commit;	/* setting value of parallel_commit
+									 * server option */
+	bool		parallel_abort; /* setting value of parallel_abort server
+								 * option */
+	int			idle_timeout;	/* setting value of idle_timeout server
+								 * option */
+	int			max_lifetime;	/* setting value of max_connection_lifetime
+								 * server option */
+	TimestampTz connected_at;	/* when conn was made */
+	TimestampTz last_used;		/* end of the last transaction using conn */
+	bool		used_in_xact;	/* got in the current transaction? */
+
+	/*
+	 * Writes of the current transaction, and routing of its reads to the
+	 * read replicas, only kept in the entry of the shared connection to the
+	 * primary.
+	 */
+	bool		xact_wrote;		/* got for a write in the transaction? */
+	int			xact_replica;	/* replica reads go to, or 0 if none yet */
+	bool		replica_counted;	/* is xact_replica counted by
+									 * mysql_replica_acquire? */
+	uint32		next_replica;	/* round robin position among replicas */
+#ifdef MYSQL_FDW_ASYNC
+	int			cmd_status;		/* events the client library waits for to
+								 * finish the command being sent, or 0 */
+	int			cmd_ret;		/* result of the command once finished */
+#endif
 	Oid			serverid;		/* foreign server OID used to get server name */
+	MySQLConnState state;		/* state shared by the scans using conn */
+
+	/* Statements prepared on conn, most recently used first */
+	dlist_head	stmt_cache;
+	int			num_stmts;		/* number of statements in stmt_cache */
+	int			max_stmts;		/* max_prepared_statements server option */
+	unsigned long stmt_thread_id;	/* remote session they were prepared in */
+	uint64		stmt_hits;		/* lookups that found a statement */
+	uint64		stmt_misses;	/* lookups that did not */
 } ConnCacheEntry;
 
+/*
+ * Prepared statement cache entry
+ *
+ * A statement is in use from its lookup, or its insertion, until the scan or
+ * modify using it gives it back.  Only idle statements are looked up and
+ * evicted, so several scans running the same query get statements of their
+ * own.
+ */
+typedef struct StmtCacheEntry
+{
+	dlist_node	node;			/* list link in ConnCacheEntry.stmt_cache */
+	char	   *query;			/* remote SQL text, the lookup key */
+	MYSQL_STMT *stmt;			/* statement prepared from query */
+	bool		in_use;			/* is the statement being used? */
+} StmtCacheEntry;
+
 /*
  * Connection cache (initialized on first use)
  */
@@ -72,9 +135,16 @@ static HTAB *ConnectionHash = NULL;
 /* tracks whether any work is needed in callback functions */
 static bool xact_got_connection = false;
 
+/* earliest time at which a cached connection expires, or DT_NOEND */
+static TimestampTz next_expiry = DT_NOEND;
+
 static void mysql_inval_callback(Datum arg, int cacheid, uint32 hashvalue);
-static void mysql_do_sql_command(MYSQL * conn, const char *sql, int level);
-static void mysql_begin_remote_xact(ConnCacheEntry *entry);
+static void mysql_do_sql_command(MYSQL * conn, const char *sql, int level,
+								 MySQLWaitEvent wait_event);
+static void mysql_begin_remote_xact(ConnCacheEntry *entry, mysql_opt * opt,
+									bool read_only);
+static void mysql_set_autocommit(ConnCacheEntry *entry, bool autocommit);
+static void mysql_set_access_mode(ConnCacheEntry *entry, bool read_only);
 static void mysql_xact_callback(XactEvent event, void *arg);
 static void mysql_subxact_callback(SubXactEvent event, SubTransactionId mySubid,
 								   SubTransactionId parentSubid, void *arg);
@@ -87,20 +157,126 @@ PG_FUNCTION_INFO_V1(mysql_fdw_disconnect);
 PG_FUNCTION_INFO_V1(mysql_fdw_disconnect_all);
 
 /* prototypes of private functions */
+static MYSQL *mysql_get_cached_connection(ForeignServer *server,
+										  UserMapping *user, mysql_opt * opt,
+										  bool read_only, bool private);
+static void mysql_init_conn_entry(ConnCacheEntry *entry);
+static int	mysql_route_connection(ConnCacheKey *key, mysql_opt * opt,
+								   bool read_only);
+static mysql_opt * mysql_replica_options(mysql_opt * opt, int replica);
+static void mysql_reset_routing(ConnCacheEntry *entry);
 static void mysql_make_new_connection(ConnCacheEntry *entry, UserMapping *user, mysql_opt * opt);
 #if PG_VERSION_NUM >= 140000
 static bool disconnect_cached_connections(Oid serverid);
 #endif
 static void disconnect_mysql_server(ConnCacheEntry *entry);
+static void mysql_discard_connection(ConnCacheEntry *entry);
+#ifdef MYSQL_FDW_ASYNC
+static void mysql_abort_pending_request(ConnCacheEntry *entry);
+static void mysql_start_sql_command(ConnCacheEntry *entry, const char *sql);
+static bool mysql_finish_sql_command(ConnCacheEntry *entry,
+									 bool interruptible);
+static void mysql_finish_xact_commands(List *pending_entries,
+									   const char *sql, int level);
+#endif
+static void mysql_reset_xact_state(ConnCacheEntry *entry);
+static TimestampTz mysql_conn_expiry(ConnCacheEntry *entry);
+static void mysql_expire_connections(TimestampTz now);
+static ConnCacheEntry *mysql_find_conn_entry(MYSQL * conn);
+static void mysql_stmt_cache_remove(ConnCacheEntry *entry,
+									StmtCacheEntry *sentry);
+static void mysql_stmt_cache_evict(ConnCacheEntry *entry);
+static void mysql_stmt_cache_flush(ConnCacheEntry *entry);
+static void mysql_stmt_cache_drop_in_use(ConnCacheEntry *entry);
 
 /*
  * mysql_get_connection:
  * 		Get a connection which can be used to execute queries on the remote
  * 		MySQL server with the user's authorization.  A new connection is
  * 		established if we don't already have a suitable one.
+ *
+ * read_only tells that the statement of the caller only reads, in which case
+ * the transaction_mode server option may let it run without a remote
+ * transaction, and it may be sent to a read replica of the server.
  */
 MYSQL *
-mysql_get_connection(ForeignServer *server, UserMapping *user, mysql_opt * opt)
+mysql_get_connection(ForeignServer *server, UserMapping *user, mysql_opt * opt,
+					 bool read_only)
+{
+	return mysql_get_cached_connection(server, user, opt, read_only, false);
+}
+
+/*
+ * mysql_get_private_connection:
+ * 		Same as mysql_get_connection, for a connection that no one else uses
+ * 		until it is given back with mysql_release_private_connection.
+ *
+ * Such connections are pooled per user and foreign server, and take part in
+ * the local transaction like the shared one, but in remote transactions of
+ * their own.  A connection is only made when all pooled ones are taken.
+ */
+MYSQL *
+mysql_get_private_connection(ForeignServer *server, UserMapping *user,
+							 mysql_opt * opt, bool read_only)
+{
+	return mysql_get_cached_connection(server, user, opt, read_only, true);
+}
+
+/*
+ * mysql_release_private_connection:
+ * 		Give back a connection got from mysql_get_private_connection.
+ *
+ * With discard, the connection is closed instead of being kept for later
+ * use, which drops any result still pending on it.  Nothing is done for a
+ * connection already closed at the end of the transaction.  This is also
+ * used from memory context reset callbacks, so it must not throw an error.
+ */
+void
+mysql_release_private_connection(MYSQL * conn, bool discard)
+{
+	ConnCacheEntry *entry = mysql_find_conn_entry(conn);
+
+	if (entry == NULL)
+		return;
+
+	Assert(entry->in_use);
+
+	if (discard)
+		mysql_discard_connection(entry);
+	else
+		entry->in_use = false;
+}
+
+/*
+ * mysql_xact_wrote:
+ * 		Tell whether the current transaction has got a connection to the
+ * 		server for a statement that writes.
+ */
+bool
+mysql_xact_wrote(ForeignServer *server, UserMapping *user)
+{
+	ConnCacheEntry *entry;
+	ConnCacheKey key;
+
+	if (ConnectionHash == NULL)
+		return false;
+
+	key.serverid = server->serverid;
+	key.userid = user->userid;
+	key.replica = 0;
+	key.slot = 0;
+	entry = hash_search(ConnectionHash, &key, HASH_FIND, NULL);
+
+	return entry != NULL && entry->xact_wrote;
+}
+
+/*
+ * mysql_get_cached_connection:
+ * 		Workhorse of mysql_get_connection and mysql_get_private_connection
+ */
+static MYSQL *
+mysql_get_cached_connection(ForeignServer *server, UserMapping *user,
+							mysql_opt * opt, bool read_only, bool private)
 {
 	bool		found;
 	ConnCacheEntry *entry;
@@ -143,20 +319,81 @@ mysql_get_connection(ForeignServer *server, UserMapping *user, mysql_opt * opt)
 	/* Create hash key for the entry.  Assume no pad bytes in key struct */
 	key.serverid = server->serverid;
 	key.userid = user->userid;
-	/* Set flag that we did GetConnection during the current transaction */
-	xact_got_connection = true;
+	key.replica = 0;
+	key.slot = 0;
 
 	/* Set flag that we did GetConnection during the current transaction */
 	xact_got_connection = true;
 
 	/*
-	 * Find or create cached entry for requested connection.
+	 * Note that the transaction writes to the server, in the entry of the
+	 * shared connection to the primary.
 	 */
-	entry = hash_search(ConnectionHash, &key, HASH_ENTER, &found);
-	if (!found)
+	if (!read_only)
 	{
-		/* Initialize new hashtable entry (key is already filled in) */
-		entry->conn = NULL;
+		entry = hash_search(ConnectionHash, &key, HASH_ENTER, &found);
+		if (!found)
+			mysql_init_conn_entry(entry);
+		entry->xact_wrote = true;
+	}
+
+	/* Reads may go to a read replica of the server */
+	if (opt->replicas != NIL)
+	{
+		key.replica = mysql_route_connection(&key, opt, read_only);
+		if (key.replica > 0)
+			opt = mysql_replica_options(opt, key.replica);
+	}
+	key.slot = private ? 1 : 0;
+
+	/*
+	 * Find or create cached entry for requested connection.  A private
+	 * connection is looked for in the following slots until a free one is
+	 * found.
+	 */
+	for (;;)
+	{
+		entry = hash_search(ConnectionHash, &key, HASH_ENTER, &found);
+		if (!found)
+			mysql_init_conn_entry(entry);
+
+		if (!entry->in_use)
+			break;
+		key.slot++;
+	}
+
+	/*
+	 * Before using again a connection left unused since an earlier
+	 * transaction, close it if it has expired, or if it was unused for a
+	 * while and the server does not answer a ping, having closed its end of
+	 * it.  A new connection is made below.
+	 */
+	if (entry->conn != NULL && !entry->used_in_xact && entry->xact_depth <= 0)
+	{
+		TimestampTz now = GetCurrentTimestamp();
+
+		if (mysql_conn_expiry(entry) <= now)
+		{
+			elog(DEBUG3, "closing expired mysql_fdw connection %p",
+				 entry->conn);
+			disconnect_mysql_server(entry);
+		}
+		else if (TimestampDifferenceExceeds(entry->last_used, now,
+											MYSQL_PING_IDLE_TIME * 1000))
+		{
+			int			rc;
+
+			pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_CONNECT));
+			rc = mysql_ping(entry->conn);
+			pgstat_report_wait_end();
+
+			if (rc != 0)
+			{
+				elog(DEBUG3, "closing broken mysql_fdw connection %p: %s",
+					 entry->conn, mysql_error(entry->conn));
+				disconnect_mysql_server(entry);
+			}
+		}
 	}
 
 	/* If an existing entry has invalid connection then release it */
@@ -177,7 +414,7 @@ mysql_get_connection(ForeignServer *server, UserMapping *user, mysql_opt * opt)
 	PG_TRY();
 	{
 		/* Start a new transaction or subtransaction if needed. */
-		mysql_begin_remote_xact(entry);
+		mysql_begin_remote_xact(entry, opt, read_only);
 	}
 	PG_CATCH();
 	{
@@ -227,23 +464,146 @@ mysql_get_connection(ForeignServer *server, UserMapping *user, mysql_opt * opt)
 		if (entry->conn == NULL)
 			mysql_make_new_connection(entry, user, opt);
 
-		mysql_begin_remote_xact(entry);
+		mysql_begin_remote_xact(entry, opt, read_only);
 	}
 
+	entry->in_use = private;
+	entry->used_in_xact = true;
+
 	return entry->conn;
 }
 
+/*
+ * Initialize a new connection cache entry (key is already filled in)
+ */
+static void
+mysql_init_conn_entry(ConnCacheEntry *entry)
+{
+	entry->conn = NULL;
+	entry->in_use = false;
+	entry->used_in_xact = false;
+	entry->xact_wrote = false;
+	entry->xact_replica = 0;
+	entry->replica_counted = false;
+	entry->next_replica = (uint32) MyProcPid;
+	MemSet(&entry->state, 0, sizeof(MySQLConnState));
+	dlist_init(&entry->stmt_cache);
+	entry->num_stmts = 0;
+	entry->stmt_hits = 0;
+	entry->stmt_misses = 0;
+}
+
+/*
+ * mysql_route_connection:
+ * 		Return the replica number, 0 for the primary, of the connection to
+ * 		get for a statement on a server with read replicas.
+ *
+ * The reads of a transaction all go to the same replica, picked when the
+ * first of them is run, so that they see the same state of the data.  Once
+ * the transaction writes to the server, all of its statements go to the
+ * primary, so that they see what it wrote.  key is that of the shared
+ * connection to the primary, whose cache entry tracks the routing.
+ */
+static int
+mysql_route_connection(ConnCacheKey *key, mysql_opt * opt, bool read_only)
+{
+	ConnCacheEntry *entry;
+	int			nreplicas = list_length(opt->replicas);
+	bool		found;
+
+	entry = hash_search(ConnectionHash, key, HASH_ENTER, &found);
+	if (!found)
+		mysql_init_conn_entry(entry);
+
+	if (entry->xact_wrote)
+		return 0;
+
+	/* The replica picked may be gone from the option since */
+	if (entry->xact_replica == 0 || entry->xact_replica > nreplicas)
+	{
+		int			replica = -1;
+
+		mysql_reset_routing(entry);
+
+		/* Without shared memory, fall back to round robin */
+		if (opt->replica_selection == MYSQL_REPLICA_SELECTION_LEAST_OUTSTANDING)
+		{
+			replica = mysql_replica_acquire(key->serverid, nreplicas);
+			entry->replica_counted = (replica >= 0);
+		}
+		if (replica < 0)
+			replica = entry->next_replica++ % nreplicas;
+
+		entry->xact_replica = replica + 1;
+		elog(DEBUG3, "mysql_fdw routing reads of the transaction to replica %d",
+			 replica);
+	}
+
+	return entry->xact_replica;
+}
+
+/*
+ * mysql_replica_options:
+ * 		Options to connect to a read replica of a server, numbered from 1:
+ * 		those of the server, with the host and port of the replica.
+ *
+ * A replica is always reached over TCP, as the socket option belongs to the
+ * primary.
+ */
+static mysql_opt *
+mysql_replica_options(mysql_opt * opt, int replica)
+{
+	MySQLReplica *r = (MySQLReplica *) list_nth(opt->replicas, replica - 1);
+	mysql_opt  *ropt = (mysql_opt *) palloc(sizeof(mysql_opt));
+
+	*ropt = *opt;
+	ropt->svr_address = r->host;
+	ropt->svr_port = r->port;
+	ropt->svr_socket = NULL;
+	ropt->transport = MYSQL_TRANSPORT_TCP;
+
+	return ropt;
+}
+
+/*
+ * Forget the routing of the reads of the transaction to a read replica.
+ * This is used at the end of transactions, so it must not throw an error.
+ */
+static void
+mysql_reset_routing(ConnCacheEntry *entry)
+{
+	if (entry->replica_counted)
+		mysql_replica_release(entry->key.serverid, entry->xact_replica - 1);
+	entry->xact_wrote = false;
+	entry->xact_replica = 0;
+	entry->replica_counted = false;
+}
+
 static void
 disconnect_mysql_server(ConnCacheEntry *entry)
 {
 	if (entry->conn)
 	{
 		elog(DEBUG3, "mysql_fdw disconnecting connection %p", entry->conn);
+		mysql_stmt_cache_flush(entry);
 		mysql_close(entry->conn);
 		entry->conn = NULL;
+		MemSet(&entry->state, 0, sizeof(MySQLConnState));
 	}
 }
 
+/*
+ * Close a private connection taken by a scan, along with its remote
+ * transaction, and make its slot free again.
+ */
+static void
+mysql_discard_connection(ConnCacheEntry *entry)
+{
+	disconnect_mysql_server(entry);
+	entry->xact_depth = 0;
+	entry->in_use = false;
+}
+
 /*
  * Reset all transient state fields in the cached connection entry and
  * establish new connection to the remote server.
@@ -279,20 +639,31 @@ mysql_make_new_connection(ConnCacheEntry *entry, UserMapping *user, mysql_opt *
 	 * By default, all the connections to any foreign servers are kept open.
 	 */
 	entry->keep_connections = true;
+	entry->parallel_commit = false;
+	entry->parallel_abort = false;
+#ifdef MYSQL_FDW_ASYNC
+	entry->cmd_status = 0;
+#endif
+	entry->max_stmts = opt->max_prepared_statements;
+	entry->idle_timeout = opt->idle_timeout;
+	entry->max_lifetime = opt->max_connection_lifetime;
 	foreach(lc, server->options)
 	{
 		DefElem    *def = (DefElem *) lfirst(lc);
 
 		if (strcmp(def->defname, "keep_connections") == 0)
-		{
 			entry->keep_connections = defGetBoolean(def);
-			break;
-		}
-
+		else if (strcmp(def->defname, "parallel_commit") == 0)
+			entry->parallel_commit = defGetBoolean(def);
+		else if (strcmp(def->defname, "parallel_abort") == 0)
+			entry->parallel_abort = defGetBoolean(def);
 	}
 
 	/* Now try to make the connection */
 	entry->conn = mysql_connect(opt);
+	entry->state.conn = entry->conn;
+	entry->connected_at = GetCurrentTimestamp();
+	entry->last_used = entry->connected_at;
 
 	elog(DEBUG3, "new mysql_fdw connection %p for server \"%s\"",
 		 entry->conn, server->servername);
@@ -342,12 +713,336 @@ mysql_release_connection(MYSQL * conn)
 		if (entry->conn == conn)
 		{
 			disconnect_mysql_server(entry);
+			entry->in_use = false;
 			hash_seq_term(&scan);
 			break;
 		}
 	}
 }
 
+/*
+ * mysql_get_conn_state
+ * 		Return the state of a connection got from mysql_get_connection, or
+ * 		NULL for a connection that is not cached.
+ */
+MySQLConnState *
+mysql_get_conn_state(MYSQL * conn)
+{
+	ConnCacheEntry *entry = mysql_find_conn_entry(conn);
+
+	return entry ? &entry->state : NULL;
+}
+
+/*
+ * mysql_check_conn_state
+ * 		Forget the session variables recorded in the state of a connection
+ * 		once the connection is on another remote session.
+ *
+ * Session variables are lost when the client library reconnects on its own,
+ * which gives a new remote session.
+ */
+void
+mysql_check_conn_state(MYSQL * conn, MySQLConnState *state)
+{
+	unsigned long thread_id = mysql_thread_id(conn);
+
+	if (state->session_thread_id != thread_id)
+	{
+		state->session_thread_id = thread_id;
+		state->sql_mode = NULL;
+		state->autocommit = NULL;
+		state->access_mode = NULL;
+		state->wait_timeout = 0;
+		state->interactive_timeout = 0;
+	}
+}
+
+/*
+ * mysql_run_query
+ * 		Send a query with mysql_query, counting it in the remote query
+ * 		statistics under the foreign server of the connection
+ *
+ * The rows of such queries are not counted, as the result of those that
+ * return some is only read afterwards.
+ */
+int
+mysql_run_query(MYSQL * conn, const char *query)
+{
+	return mysql_run_query_wait(conn, query, MYSQL_WAIT_EVENT_EXECUTE);
+}
+
+/*
+ * mysql_run_query_wait
+ * 		Same as mysql_run_query, reporting the given wait event while the
+ * 		query runs
+ */
+int
+mysql_run_query_wait(MYSQL * conn, const char *query,
+					 MySQLWaitEvent wait_event)
+{
+	ConnCacheEntry *entry;
+	instr_time	start;
+	instr_time	elapsed;
+	int			rc;
+
+	if (!mysql_stat_enabled())
+	{
+		pgstat_report_wait_start(mysql_wait_event(wait_event));
+		rc = mysql_query(conn, query);
+		pgstat_report_wait_end();
+
+		return rc;
+	}
+
+	INSTR_TIME_SET_CURRENT(start);
+	pgstat_report_wait_start(mysql_wait_event(wait_event));
+	rc = mysql_query(conn, query);
+	pgstat_report_wait_end();
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, start);
+
+	entry = mysql_find_conn_entry(conn);
+	mysql_stat_record(entry ? entry->serverid : InvalidOid, query,
+					  INSTR_TIME_GET_MILLISEC(elapsed), 0, 0);
+
+	return rc;
+}
+
+/*
+ * mysql_find_conn_entry
+ * 		Return the cache entry of a connection got from mysql_get_connection,
+ * 		or NULL for a connection that is not cached.
+ */
+static ConnCacheEntry *
+mysql_find_conn_entry(MYSQL * conn)
+{
+	HASH_SEQ_STATUS scan;
+	ConnCacheEntry *entry;
+
+	if (ConnectionHash == NULL || conn == NULL)
+		return NULL;
+
+	hash_seq_init(&scan, ConnectionHash);
+	while ((entry = (ConnCacheEntry *) hash_seq_search(&scan)))
+	{
+		if (entry->conn == conn)
+		{
+			hash_seq_term(&scan);
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * mysql_stmt_cache_lookup
+ * 		Get an idle statement prepared from query on a cached connection, or
+ * 		NULL if there is none.
+ *
+ * The statement is in use until given back with mysql_stmt_cache_release.
+ */
+MYSQL_STMT *
+mysql_stmt_cache_lookup(MYSQL * conn, const char *query)
+{
+	ConnCacheEntry *entry = mysql_find_conn_entry(conn);
+	dlist_iter	iter;
+
+	if (entry == NULL || entry->max_stmts == 0 || entry->key.slot > 0)
+		return NULL;
+
+	/*
+	 * Prepared statements belong to the remote session, so they are lost
+	 * when the client library reconnects on its own.
+	 */
+	if (entry->num_stmts > 0 &&
+		mysql_thread_id(conn) != entry->stmt_thread_id)
+		mysql_stmt_cache_flush(entry);
+
+	dlist_foreach(iter, &entry->stmt_cache)
+	{
+		StmtCacheEntry *sentry = dlist_container(StmtCacheEntry, node,
+												 iter.cur);
+
+		if (!sentry->in_use && strcmp(sentry->query, query) == 0)
+		{
+			sentry->in_use = true;
+			dlist_move_head(&entry->stmt_cache, &sentry->node);
+			entry->stmt_hits++;
+			return sentry->stmt;
+		}
+	}
+
+	entry->stmt_misses++;
+	return NULL;
+}
+
+/*
+ * mysql_stmt_cache_insert
+ * 		Add a statement just prepared from query to the cache of its
+ * 		connection, marked as in use.
+ *
+ * Nothing is done for a connection that is not cached, a private one, or
+ * one whose cache is disabled; mysql_stmt_cache_release then closes the
+ * statement.  The statements of a private connection are left to the scan
+ * that has it, which closes them together with the connection.
+ */
+void
+mysql_stmt_cache_insert(MYSQL * conn, const char *query, MYSQL_STMT * stmt)
+{
+	ConnCacheEntry *entry = mysql_find_conn_entry(conn);
+	StmtCacheEntry *sentry;
+
+	if (entry == NULL || entry->max_stmts == 0 || entry->key.slot > 0)
+		return;
+
+	if (entry->num_stmts == 0)
+		entry->stmt_thread_id = mysql_thread_id(conn);
+
+	sentry = (StmtCacheEntry *) MemoryContextAlloc(CacheMemoryContext,
+												   sizeof(StmtCacheEntry));
+	sentry->query = MemoryContextStrdup(CacheMemoryContext, query);
+	sentry->stmt = stmt;
+	sentry->in_use = true;
+	dlist_push_head(&entry->stmt_cache, &sentry->node);
+	entry->num_stmts++;
+
+	mysql_stmt_cache_evict(entry);
+}
+
+/*
+ * mysql_stmt_cache_release
+ * 		Give back a statement got from mysql_stmt_cache_lookup, or passed to
+ * 		mysql_stmt_cache_insert.  Statements that are not cached are closed.
+ *
+ * reset tells that the statement may have a cursor still open on the server,
+ * which is then closed.  Otherwise only what the client library keeps of the
+ * last result is dropped, which needs no round trip.
+ */
+void
+mysql_stmt_cache_release(MYSQL * conn, MYSQL_STMT * stmt, bool reset)
+{
+	ConnCacheEntry *entry = mysql_find_conn_entry(conn);
+
+	if (entry != NULL)
+	{
+		dlist_iter	iter;
+
+		dlist_foreach(iter, &entry->stmt_cache)
+		{
+			StmtCacheEntry *sentry = dlist_container(StmtCacheEntry, node,
+													 iter.cur);
+
+			if (sentry->stmt != stmt)
+				continue;
+
+			/*
+			 * Drop unread rows, and close any cursor left open, so that the
+			 * next user of the statement starts afresh.  A statement that
+			 * cannot be reset is not worth keeping.
+			 */
+			if ((reset ? mysql_stmt_reset(stmt) :
+				 mysql_stmt_free_result(stmt)) == 0)
+			{
+				sentry->in_use = false;
+				mysql_stmt_cache_evict(entry);
+				return;
+			}
+
+			dlist_delete(&sentry->node);
+			entry->num_stmts--;
+			pfree(sentry->query);
+			pfree(sentry);
+			break;
+		}
+	}
+
+	mysql_stmt_close(stmt);
+}
+
+/*
+ * mysql_stmt_cache_remove
+ * 		Remove a statement from the cache of a connection.
+ *
+ * An idle statement is closed.  One in use is closed once given back, as it
+ * is not found in the cache anymore.
+ */
+static void
+mysql_stmt_cache_remove(ConnCacheEntry *entry, StmtCacheEntry *sentry)
+{
+	dlist_delete(&sentry->node);
+	entry->num_stmts--;
+
+	if (!sentry->in_use)
+		mysql_stmt_close(sentry->stmt);
+
+	pfree(sentry->query);
+	pfree(sentry);
+}
+
+/*
+ * mysql_stmt_cache_evict
+ * 		Close the least recently used idle statements of a connection until
+ * 		the cache fits max_prepared_statements.
+ */
+static void
+mysql_stmt_cache_evict(ConnCacheEntry *entry)
+{
+	dlist_node *cur;
+	dlist_node *prev;
+
+	for (cur = entry->stmt_cache.head.prev;
+		 cur != &entry->stmt_cache.head &&
+		 entry->num_stmts > entry->max_stmts;
+		 cur = prev)
+	{
+		StmtCacheEntry *sentry = dlist_container(StmtCacheEntry, node, cur);
+
+		prev = cur->prev;
+		if (!sentry->in_use)
+			mysql_stmt_cache_remove(entry, sentry);
+	}
+}
+
+/*
+ * mysql_stmt_cache_flush
+ * 		Empty the prepared statement cache of a connection.
+ */
+static void
+mysql_stmt_cache_flush(ConnCacheEntry *entry)
+{
+	dlist_mutable_iter iter;
+
+	dlist_foreach_modify(iter, &entry->stmt_cache)
+		mysql_stmt_cache_remove(entry,
+								dlist_container(StmtCacheEntry, node,
+												iter.cur));
+}
+
+/*
+ * mysql_stmt_cache_drop_in_use
+ * 		Close the statements of a connection still in use at the end of a
+ * 		transaction.  They belong to scans and modifies that an error kept
+ * 		from ending, so they would never be given back.
+ */
+static void
+mysql_stmt_cache_drop_in_use(ConnCacheEntry *entry)
+{
+	dlist_mutable_iter iter;
+
+	dlist_foreach_modify(iter, &entry->stmt_cache)
+	{
+		StmtCacheEntry *sentry = dlist_container(StmtCacheEntry, node,
+												 iter.cur);
+
+		if (sentry->in_use)
+		{
+			sentry->in_use = false;
+			mysql_stmt_cache_remove(entry, sentry);
+		}
+	}
+}
+
 MYSQL *
 mysql_connect(mysql_opt * opt)
 {
@@ -356,6 +1051,8 @@ mysql_connect(mysql_opt * opt)
 	bool		svr_sa = opt->svr_sa;
 	char	   *svr_init_command = opt->svr_init_command;
 	char	   *ssl_cipher = opt->ssl_cipher;
+	bool		report_truncation = true;
+	bool		connected;
 #if	MYSQL_VERSION_ID < 80000
 	my_bool		secure_auth = svr_sa;
 #endif
@@ -384,12 +1081,91 @@ mysql_connect(mysql_opt * opt)
 	 */
 	mysql_options(conn, MYSQL_OPT_RECONNECT, &opt->reconnect);
 
+	/*
+	 * Bind buffers are sized from the result set metadata, so make sure
+	 * values that do not fit are reported rather than silently cut.
+	 */
+	mysql_options(conn, MYSQL_REPORT_DATA_TRUNCATION, &report_truncation);
+
+#ifdef MYSQL_FDW_ASYNC
+	/* Allow queries of asynchronous scans to be run without blocking */
+	if (mysql_async_supported)
+		mysql_options(conn, MYSQL_OPT_NONBLOCK, 0);
+#endif
+
+	/*
+	 * Compress the protocol traffic if asked to.  Client libraries without
+	 * the choice of the algorithm only have zlib.
+	 */
+	if (opt->compression != MYSQL_COMPRESSION_OFF)
+	{
+#ifdef MYSQL_FDW_COMPRESSION_ALGORITHMS
+		if (opt->compression == MYSQL_COMPRESSION_ZSTD)
+		{
+			mysql_options(conn, MYSQL_OPT_COMPRESSION_ALGORITHMS, "zstd");
+			if (opt->compression_level > 0)
+			{
+				unsigned int level = opt->compression_level;
+
+				mysql_options(conn, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL, &level);
+			}
+		}
+		else
+			mysql_options(conn, MYSQL_OPT_COMPRESSION_ALGORITHMS, "zlib");
+#else
+		if (opt->compression == MYSQL_COMPRESSION_ZSTD)
+		{
+			mysql_close(conn);
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("zstd compression is not supported by the MySQL client library mysql_fdw was built with")));
+		}
+		mysql_options(conn, MYSQL_OPT_COMPRESS, NULL);
+#endif
+	}
+
+	/*
+	 * Reach the server the way asked.  The socket option names the Unix-domain
+	 * socket or the named pipe, passed to mysql_real_connect(), or the shared
+	 * memory.
+	 */
+	if (opt->transport != MYSQL_TRANSPORT_DEFAULT)
+	{
+		unsigned int protocol;
+
+		switch (opt->transport)
+		{
+			case MYSQL_TRANSPORT_SOCKET:
+				protocol = MYSQL_PROTOCOL_SOCKET;
+				break;
+			case MYSQL_TRANSPORT_PIPE:
+				protocol = MYSQL_PROTOCOL_PIPE;
+				break;
+			case MYSQL_TRANSPORT_MEMORY:
+				protocol = MYSQL_PROTOCOL_MEMORY;
+				if (opt->svr_socket != NULL)
+					mysql_options(conn, MYSQL_SHARED_MEMORY_BASE_NAME,
+								  opt->svr_socket);
+				break;
+			default:
+				protocol = MYSQL_PROTOCOL_TCP;
+				break;
+		}
+		mysql_options(conn, MYSQL_OPT_PROTOCOL, &protocol);
+	}
+
 	mysql_ssl_set(conn, opt->ssl_key, opt->ssl_cert, opt->ssl_ca,
 				  opt->ssl_capath, ssl_cipher);
 
-	if (!mysql_real_connect(conn, opt->svr_address, opt->svr_username,
-							opt->svr_password, svr_database, opt->svr_port,
-							NULL, 0))
+	pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_CONNECT));
+	connected = mysql_real_connect(conn, opt->svr_address, opt->svr_username,
+								   opt->svr_password, svr_database,
+								   opt->svr_port,
+								   opt->transport == MYSQL_TRANSPORT_MEMORY ?
+								   NULL : opt->svr_socket, 0) != NULL;
+	pgstat_report_wait_end();
+
+	if (!connected)
 		ereport(ERROR,
 				(errcode(ERRCODE_FDW_UNABLE_TO_ESTABLISH_CONNECTION),
 				 errmsg("failed to connect to MySQL: %s", mysql_error(conn))));
@@ -447,7 +1223,10 @@ mysql_inval_callback(Datum arg, int cacheid, uint32 hashvalue)
 				disconnect_mysql_server(entry);
 			}
 			else
+			{
 				entry->invalidated = true;
+				mysql_stmt_cache_flush(entry);
+			}
 		}
 		entry->invalidated = true;
 	}
@@ -457,11 +1236,12 @@ mysql_inval_callback(Datum arg, int cacheid, uint32 hashvalue)
  * Convenience subroutine to issue a non-data-returning SQL command to remote
  */
 static void
-mysql_do_sql_command(MYSQL * conn, const char *sql, int level)
+mysql_do_sql_command(MYSQL * conn, const char *sql, int level,
+					 MySQLWaitEvent wait_event)
 {
 	elog(DEBUG3, "mysql_fdw do_sql_command %s", sql);
 
-	if (mysql_query(conn, sql) != 0)
+	if (mysql_run_query_wait(conn, sql, wait_event) != 0)
 	{
 		ereport(level,
 				(errcode(ERRCODE_FDW_ERROR),
@@ -472,21 +1252,52 @@ mysql_do_sql_command(MYSQL * conn, const char *sql, int level)
 
 /*
  * Start remote transaction or subtransaction, if needed.
+ *
+ * Rather than sending START TRANSACTION on its own, the session is put in
+ * non-autocommit mode, so that the first statement sent begins the remote
+ * transaction.  The remote transaction of a read-only local transaction is
+ * made read-only the same way, through the session's transaction access mode.
+ * Both are only set when the session is not in that mode already.  An
+ * explicit START TRANSACTION is still sent when the client library reconnects
+ * on its own, which would silently reset the modes of the new session.
+ *
+ * The remote transaction lasts as long as the local one, whose later
+ * statements may write, so only a read-only local transaction gets a
+ * read-only remote one, whatever the statement starting it does.
+ *
+ * With the autocommit transaction mode, a statement that only reads and is
+ * not in a transaction block runs in autocommit mode, without any remote
+ * transaction.
  */
 static void
-mysql_begin_remote_xact(ConnCacheEntry *entry)
+mysql_begin_remote_xact(ConnCacheEntry *entry, mysql_opt * opt,
+						bool read_only)
 {
 	int			curlevel = GetCurrentTransactionNestLevel();
 
 	/* Start main transaction if we haven't yet */
 	if (entry->xact_depth <= 0)
 	{
-		const char *sql = "START TRANSACTION";
+		if (opt->transaction_mode == MYSQL_TRANSACTION_MODE_AUTOCOMMIT &&
+			read_only && !IsTransactionBlock())
+		{
+			mysql_set_autocommit(entry, true);
+			return;
+		}
 
 		elog(DEBUG3, "mysql_fdw starting remote transaction on connection %p",
 			 entry->conn);
 
-		mysql_do_sql_command(entry->conn, sql, ERROR);
+		if (opt->reconnect)
+			mysql_do_sql_command(entry->conn,
+								 XactReadOnly ? "START TRANSACTION READ ONLY" :
+								 "START TRANSACTION",
+								 ERROR, MYSQL_WAIT_EVENT_EXECUTE);
+		else
+		{
+			mysql_set_access_mode(entry, XactReadOnly);
+			mysql_set_autocommit(entry, false);
+		}
 		entry->xact_depth = 1;
 	}
 
@@ -499,11 +1310,55 @@ mysql_begin_remote_xact(ConnCacheEntry *entry)
 	{
 		const char *sql = psprintf("SAVEPOINT s%d", entry->xact_depth + 1);
 
-		mysql_do_sql_command(entry->conn, sql, ERROR);
+		mysql_do_sql_command(entry->conn, sql, ERROR,
+							 MYSQL_WAIT_EVENT_EXECUTE);
 		entry->xact_depth++;
 	}
 }
 
+/*
+ * Put the session of a connection in autocommit mode or out of it, unless it
+ * is known to be in that mode already.
+ */
+static void
+mysql_set_autocommit(ConnCacheEntry *entry, bool autocommit)
+{
+	const char *value = autocommit ? "1" : "0";
+
+	mysql_check_conn_state(entry->conn, &entry->state);
+
+	if (entry->state.autocommit != NULL &&
+		strcmp(entry->state.autocommit, value) == 0)
+		return;
+
+	mysql_do_sql_command(entry->conn,
+						 autocommit ? "SET autocommit = 1" : "SET autocommit = 0",
+						 ERROR, MYSQL_WAIT_EVENT_EXECUTE);
+	entry->state.autocommit = value;
+}
+
+/*
+ * Set the access mode of the transactions of a connection's session, unless
+ * it is known to be that mode already.
+ */
+static void
+mysql_set_access_mode(ConnCacheEntry *entry, bool read_only)
+{
+	const char *value = read_only ? "READ ONLY" : "READ WRITE";
+
+	mysql_check_conn_state(entry->conn, &entry->state);
+
+	if (entry->state.access_mode != NULL &&
+		strcmp(entry->state.access_mode, value) == 0)
+		return;
+
+	mysql_do_sql_command(entry->conn,
+						 read_only ? "SET SESSION TRANSACTION READ ONLY" :
+						 "SET SESSION TRANSACTION READ WRITE",
+						 ERROR, MYSQL_WAIT_EVENT_EXECUTE);
+	entry->state.access_mode = value;
+}
+
 /*
  * mysql_xact_callback --- cleanup at main-transaction end.
  */
@@ -512,10 +1367,23 @@ mysql_xact_callback(XactEvent event, void *arg)
 {
 	HASH_SEQ_STATUS scan;
 	ConnCacheEntry *entry;
+#ifdef MYSQL_FDW_ASYNC
+	List	   *pending_entries = NIL;
+#endif
+	TimestampTz now;
 
-	/* Quick exit if no connections were touched in this transaction. */
+	/*
+	 * Quick exit if no connections were touched in this transaction.  Cached
+	 * connections may still have expired in the meantime.
+	 */
 	if (!xact_got_connection)
+	{
+		if (next_expiry != DT_NOEND &&
+			(event == XACT_EVENT_COMMIT || event == XACT_EVENT_ABORT))
+			mysql_expire_connections(GetCurrentTimestamp());
 		return;
+	}
+	now = GetCurrentTimestamp();
 
 	elog(DEBUG1, "mysql_fdw xact_callback %d", event);
 
@@ -526,10 +1394,48 @@ mysql_xact_callback(XactEvent event, void *arg)
 	hash_seq_init(&scan, ConnectionHash);
 	while ((entry = (ConnCacheEntry *) hash_seq_search(&scan)))
 	{
+		/* The next transaction picks its replica anew */
+		mysql_reset_routing(entry);
+
 		/* Ignore cache entry if no open connection right now */
 		if (entry->conn == NULL)
 			continue;
 
+		/* Idle time runs from the end of the last transaction using conn */
+		if (entry->used_in_xact)
+		{
+			entry->used_in_xact = false;
+			entry->last_used = now;
+			next_expiry = Min(next_expiry, mysql_conn_expiry(entry));
+		}
+
+		/*
+		 * A private connection still taken belongs to a scan that an error
+		 * kept from ending, and may have the rest of its result pending, so
+		 * it is closed rather than kept.
+		 */
+		if (entry->in_use)
+		{
+			mysql_discard_connection(entry);
+			continue;
+		}
+
+#ifdef MYSQL_FDW_ASYNC
+		if (event == XACT_EVENT_PARALLEL_ABORT || event == XACT_EVENT_ABORT)
+		{
+			mysql_abort_pending_request(entry);
+
+			/*
+			 * An error while ending the remote transactions in parallel may
+			 * leave a COMMIT in flight.
+			 */
+			if (entry->cmd_status != 0)
+				(void) mysql_finish_sql_command(entry, false);
+		}
+#endif
+
+		mysql_stmt_cache_drop_in_use(entry);
+
 		/* If it has an open remote transaction, try to close it */
 		if (entry->xact_depth > 0)
 		{
@@ -540,8 +1446,22 @@ mysql_xact_callback(XactEvent event, void *arg)
 			{
 				case XACT_EVENT_PARALLEL_PRE_COMMIT:
 				case XACT_EVENT_PRE_COMMIT:
+#ifdef MYSQL_FDW_ASYNC
+
+					/*
+					 * With parallel_commit, only send the COMMIT here, and
+					 * wait for it with those of the other connections.
+					 */
+					if (entry->parallel_commit && mysql_async_supported)
+					{
+						mysql_start_sql_command(entry, "COMMIT");
+						pending_entries = lappend(pending_entries, entry);
+						continue;
+					}
+#endif
 					/* Commit all remote transactions */
-					mysql_do_sql_command(entry->conn, "COMMIT", ERROR);
+					mysql_do_sql_command(entry->conn, "COMMIT", ERROR,
+										 MYSQL_WAIT_EVENT_COMMIT);
 					break;
 				case XACT_EVENT_PRE_PREPARE:
 
@@ -569,23 +1489,41 @@ mysql_xact_callback(XactEvent event, void *arg)
 					{
 						elog(DEBUG3, "mysql_fdw abort transaction");
 
+#ifdef MYSQL_FDW_ASYNC
+						if (entry->parallel_abort && mysql_async_supported)
+						{
+							mysql_start_sql_command(entry, "ROLLBACK");
+							pending_entries = lappend(pending_entries, entry);
+							continue;
+						}
+#endif
+
 						/*
 						 * rollback if in transaction
 						 */
-						mysql_do_sql_command(entry->conn, "ROLLBACK", WARNING);
+						mysql_do_sql_command(entry->conn, "ROLLBACK", WARNING,
+											 MYSQL_WAIT_EVENT_COMMIT);
 						break;
 					}
 			}
 		}
 
-		/* Reset state to show we're out of a transaction */
-		entry->xact_depth = 0;
-		if (entry->invalidated || !entry->keep_connections)
-		{
-			elog(DEBUG3, "mysql_fdw discarding connection %p", entry->conn);
-			disconnect_mysql_server(entry);
-		}
+		mysql_reset_xact_state(entry);
+	}
+
+#ifdef MYSQL_FDW_ASYNC
+	/* Wait for the commands sent to all connections at once */
+	if (pending_entries != NIL)
+	{
+		if (event == XACT_EVENT_PARALLEL_PRE_COMMIT ||
+			event == XACT_EVENT_PRE_COMMIT)
+			mysql_finish_xact_commands(pending_entries, "COMMIT", ERROR);
+		else
+			mysql_finish_xact_commands(pending_entries, "ROLLBACK", WARNING);
 	}
+#endif
+
+	mysql_expire_connections(now);
 
 	/*
 	 * Regardless of the event type, we can now mark ourselves as out of the
@@ -594,6 +1532,188 @@ mysql_xact_callback(XactEvent event, void *arg)
 	xact_got_connection = false;
 }
 
+/*
+ * Reset the state of a connection to show we're out of a transaction, and
+ * discard the connection if it's not to be kept.
+ */
+static void
+mysql_reset_xact_state(ConnCacheEntry *entry)
+{
+	entry->xact_depth = 0;
+	if (entry->invalidated || !entry->keep_connections)
+	{
+		elog(DEBUG3, "mysql_fdw discarding connection %p", entry->conn);
+		disconnect_mysql_server(entry);
+	}
+}
+
+/*
+ * Time at which a connection expires under its idle_timeout and
+ * max_connection_lifetime options, or DT_NOEND if it does not.
+ */
+static TimestampTz
+mysql_conn_expiry(ConnCacheEntry *entry)
+{
+	TimestampTz expiry = DT_NOEND;
+
+	if (entry->idle_timeout > 0)
+		expiry = TimestampTzPlusMilliseconds(entry->last_used,
+											 (int64) entry->idle_timeout * 1000);
+	if (entry->max_lifetime > 0)
+		expiry = Min(expiry,
+					 TimestampTzPlusMilliseconds(entry->connected_at,
+												 (int64) entry->max_lifetime * 1000));
+
+	return expiry;
+}
+
+/*
+ * Close the cached connections that have expired and are not used by the
+ * current transaction.
+ *
+ * The connection cache is only scanned once the earliest expiry time is
+ * reached, so this is cheap enough to be done at the end of each
+ * transaction.
+ */
+static void
+mysql_expire_connections(TimestampTz now)
+{
+	HASH_SEQ_STATUS scan;
+	ConnCacheEntry *entry;
+
+	if (now < next_expiry)
+		return;
+
+	next_expiry = DT_NOEND;
+
+	hash_seq_init(&scan, ConnectionHash);
+	while ((entry = (ConnCacheEntry *) hash_seq_search(&scan)))
+	{
+		TimestampTz expiry;
+
+		if (entry->conn == NULL)
+			continue;
+
+		expiry = mysql_conn_expiry(entry);
+		if (expiry <= now && entry->xact_depth <= 0 && !entry->in_use)
+		{
+			elog(DEBUG3, "closing expired mysql_fdw connection %p",
+				 entry->conn);
+			disconnect_mysql_server(entry);
+			continue;
+		}
+
+		next_expiry = Min(next_expiry, expiry);
+	}
+}
+
+#ifdef MYSQL_FDW_ASYNC
+/*
+ * Send a non-data-returning SQL command to remote without waiting for it to
+ * finish; mysql_finish_sql_command() takes its outcome.
+ */
+static void
+mysql_start_sql_command(ConnCacheEntry *entry, const char *sql)
+{
+	elog(DEBUG3, "mysql_fdw start_sql_command %s", sql);
+
+	entry->cmd_status = mysql_real_query_start(&entry->cmd_ret, entry->conn,
+											   sql, strlen(sql));
+}
+
+/*
+ * Wait until the command sent by mysql_start_sql_command() has finished, and
+ * tell whether it succeeded.
+ *
+ * With interruptible, interrupts are serviced while waiting, leaving the
+ * command in flight for the abort of the transaction to finish.  That uses
+ * this without interruptible, as it must not throw an error.
+ */
+static bool
+mysql_finish_sql_command(ConnCacheEntry *entry, bool interruptible)
+{
+	while (entry->cmd_status != 0)
+	{
+		uint32		events;
+		long		timeout;
+		int			rc;
+
+		events = mysql_async_wait_events(entry->conn, entry->cmd_status,
+										 &timeout);
+		if (interruptible)
+			events |= WL_LATCH_SET;
+
+		rc = WaitLatchOrSocket(interruptible ? MyLatch : NULL,
+							   events | WL_EXIT_ON_PM_DEATH,
+							   mysql_get_socket(entry->conn), timeout,
+							   mysql_wait_event(MYSQL_WAIT_EVENT_COMMIT));
+
+		if (rc & WL_LATCH_SET)
+		{
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+
+			/* Only the latch was set, wait for the connection again */
+			if (mysql_async_ready_status(entry->cmd_status, rc) == 0)
+				continue;
+		}
+
+		entry->cmd_status =
+			mysql_real_query_cont(&entry->cmd_ret, entry->conn,
+								  mysql_async_ready_status(entry->cmd_status,
+														   rc));
+	}
+
+	return entry->cmd_ret == 0;
+}
+
+/*
+ * Take the outcome of the COMMIT or ROLLBACK sent to each of the given
+ * connections, which end their remote transaction in parallel.
+ *
+ * As when the commands are sent one after the other, a failed COMMIT is
+ * reported as an ERROR, which rolls back the transactions of the connections
+ * not committed yet, and a failed ROLLBACK as a WARNING.  All commands are
+ * finished before reporting, so that no connection is left with a command
+ * in flight; the transaction of a connection whose COMMIT failed stays open
+ * for the abort to roll back.  A query cancel gets through while waiting for
+ * the COMMITs, but not for the ROLLBACKs of an abort.
+ */
+static void
+mysql_finish_xact_commands(List *pending_entries, const char *sql, int level)
+{
+	ConnCacheEntry *failed = NULL;
+	ListCell   *lc;
+
+	foreach(lc, pending_entries)
+	{
+		ConnCacheEntry *entry = (ConnCacheEntry *) lfirst(lc);
+
+		if (!mysql_finish_sql_command(entry, level >= ERROR))
+		{
+			if (level < ERROR)
+				ereport(level,
+						(errcode(ERRCODE_FDW_ERROR),
+						 errmsg("mysql_fdw: failed to execute sql: %s, Error %u: %s\n", sql, mysql_errno(entry->conn), mysql_error(entry->conn))
+						 ));
+			else if (failed == NULL)
+			{
+				failed = entry;
+				continue;
+			}
+		}
+
+		mysql_reset_xact_state(entry);
+	}
+
+	if (failed != NULL)
+		ereport(level,
+				(errcode(ERRCODE_FDW_ERROR),
+				 errmsg("mysql_fdw: failed to execute sql: %s, Error %u: %s\n", sql, mysql_errno(failed->conn), mysql_error(failed->conn))
+				 ));
+}
+#endif
+
 /*
  * mysql_subxact_callback --- cleanup at subtransaction end.
  */
@@ -639,7 +1759,8 @@ mysql_subxact_callback(SubXactEvent event, SubTransactionId mySubid,
 		{
 			/* Commit all remote subtransactions during pre-commit */
 			snprintf(sql, sizeof(sql), "RELEASE SAVEPOINT s%d", curlevel);
-			mysql_do_sql_command(entry->conn, sql, ERROR);
+			mysql_do_sql_command(entry->conn, sql, ERROR,
+								 MYSQL_WAIT_EVENT_EXECUTE);
 		}
 		else if (in_error_recursion_trouble())
 		{
@@ -648,17 +1769,32 @@ mysql_subxact_callback(SubXactEvent event, SubTransactionId mySubid,
 			 * recursion trouble.
 			 */
 		}
+		else if (entry->in_use)
+		{
+			/*
+			 * Same as at the end of the transaction, for a private connection
+			 * taken in the subtransaction.
+			 */
+			mysql_discard_connection(entry);
+			continue;
+		}
 		else
 		{
+#ifdef MYSQL_FDW_ASYNC
+			mysql_abort_pending_request(entry);
+#endif
+
 			/* Rollback all remote subtransactions during abort */
 			snprintf(sql, sizeof(sql),
 					 "ROLLBACK TO SAVEPOINT s%d",
 					 curlevel);
-			mysql_do_sql_command(entry->conn, sql, ERROR);
+			mysql_do_sql_command(entry->conn, sql, ERROR,
+								 MYSQL_WAIT_EVENT_EXECUTE);
 			snprintf(sql, sizeof(sql),
 					 "RELEASE SAVEPOINT s%d",
 					 curlevel);
-			mysql_do_sql_command(entry->conn, sql, ERROR);
+			mysql_do_sql_command(entry->conn, sql, ERROR,
+								 MYSQL_WAIT_EVENT_EXECUTE);
 		}
 
 		/* OK, we're outta that level of subtransaction */
@@ -666,6 +1802,29 @@ mysql_subxact_callback(SubXactEvent event, SubTransactionId mySubid,
 	}
 }
 
+#ifdef MYSQL_FDW_ASYNC
+/*
+ * mysql_abort_pending_request
+ * 		Wait for the end of a query that an aborted scan left executing
+ * 		asynchronously, and discard its result, so that the connection can be
+ * 		used to roll back.
+ */
+static void
+mysql_abort_pending_request(ConnCacheEntry *entry)
+{
+	MySQLConnState *state = &entry->state;
+
+	if (state->pending_areq == NULL)
+		return;
+
+	mysql_finish_async_execute(state, false);
+	mysql_stmt_reset(state->pending_stmt);
+
+	state->pending_areq = NULL;
+	state->pending_stmt = NULL;
+}
+#endif
+
 /*
  * List active foreign server connections.
  *
@@ -676,6 +1835,11 @@ mysql_subxact_callback(SubXactEvent event, SubTransactionId mySubid,
  *   be NULL in output.
  * - valid - true/false representing whether the connection is valid or not.
  * 	 Note that the connections can get invalidated in pgfdw_inval_callback.
+ * - stmt_cache_hits - number of statements found in the prepared statement
+ *   cache of the connection.
+ * - stmt_cache_misses - number of statements that had to be prepared.
+ *
+ * The last two are only returned from version 1.3 of the extension on.
  *
  * No records are returned when there are no cached connections at all.
  */
@@ -683,7 +1847,7 @@ Datum
 mysql_fdw_get_connections(PG_FUNCTION_ARGS)
 #if PG_VERSION_NUM >= 140000
 {
-#define MYSQL_FDW_GET_CONNECTIONS_COLS	2
+#define MYSQL_FDW_GET_CONNECTIONS_COLS	4
 	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
 	TupleDesc	tupdesc;
 	Tuplestorestate *tupstore;
@@ -786,6 +1950,12 @@ mysql_fdw_get_connections(PG_FUNCTION_ARGS)
 
 		values[1] = BoolGetDatum(!entry->invalidated);
 
+		if (tupdesc->natts >= MYSQL_FDW_GET_CONNECTIONS_COLS)
+		{
+			values[2] = Int64GetDatum((int64) entry->stmt_hits);
+			values[3] = Int64GetDatum((int64) entry->stmt_misses);
+		}
+
 		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
 	}
 
@@ -909,9 +2079,10 @@ disconnect_cached_connections(Oid serverid)
 		{
 			/*
 			 * Emit a warning because the connection to close is used in the
-			 * current transaction and cannot be disconnected right now.
+			 * current transaction, or by a running scan, and cannot be
+			 * disconnected right now.
 			 */
-			if (entry->xact_depth > 0)
+			if (entry->xact_depth > 0 || entry->in_use)
 			{
 				ForeignServer *server;
 
@@ -938,9 +2109,7 @@ disconnect_cached_connections(Oid serverid)
 			}
 			else
 			{
-				elog(DEBUG3, "mysql_fdw discarding connection %p", entry->conn);
-				mysql_close(entry->conn);
-				entry->conn = NULL;
+				disconnect_mysql_server(entry);
 				result = true;
 			}
 		}
@@ -801,6 +801,64 @@ mysql_deparse_analyze(StringInfo sql, char *dbname, char *relname)
 					 dbname, relname);
 }
 
+/*
+ * Append the condition restricting a parallel scan of a foreign table to a
+ * range of its key, which is its first column.  The bounds of the range, and
+ * whether the rows with a NULL key belong to it, are the last three
+ * parameters of the query.
+ */
+void
+mysql_append_parallel_range_clause(StringInfo buf, PlannerInfo *root,
+								   RelOptInfo *baserel, bool is_first)
+{
+	RangeTblEntry *rte = planner_rt_fetch(baserel->relid, root);
+	char	   *colname;
+
+	colname = mysql_quote_identifier(mysql_get_column_name(rte->relid, 1),
+									 '`');
+
+	appendStringInfo(buf, "%s(%s BETWEEN ? AND ? OR ? AND %s IS NULL)",
+					 is_first ? " WHERE " : " AND ", colname, colname);
+}
+
+/*
+ * Append the condition restricting a batched parameterized scan of a foreign
+ * table to a window of values of the given key column.  The bounds of the
+ * window are the last two parameters of the query.
+ */
+void
+mysql_append_rescan_batch_clause(StringInfo buf, PlannerInfo *root,
+								 RelOptInfo *baserel, AttrNumber attnum,
+								 bool is_first)
+{
+	RangeTblEntry *rte = planner_rt_fetch(baserel->relid, root);
+	char	   *colname;
+
+	colname = mysql_quote_identifier(mysql_get_column_name(rte->relid,
+														   attnum),
+									 '`');
+
+	appendStringInfo(buf, "%s(%s BETWEEN ? AND ?)",
+					 is_first ? " WHERE " : " AND ", colname);
+}
+
+/*
+ * Construct a query returning the lowest and highest values of the key of a
+ * foreign table, which a parallel scan splits in ranges.
+ */
+void
+mysql_deparse_key_range(StringInfo buf, Relation rel)
+{
+	char	   *colname;
+
+	colname = mysql_quote_identifier(mysql_get_column_name(RelationGetRelid(rel),
+														   1),
+									 '`');
+
+	appendStringInfo(buf, "SELECT MIN(%s), MAX(%s) FROM ", colname, colname);
+	mysql_deparse_relation(buf, rel);
+}
+
 /*
  * Emit a target list that retrieves the columns specified in attrs_used.
  * This is used for both SELECT and RETURNING targetlists; the is_returning
@@ -1118,44 +1176,57 @@ mysql_deparse_column_ref(StringInfo buf, int varno, int varattno,
 	}
 	else
 	{
-		char	   *colname = NULL;
-		List	   *options;
-		ListCell   *lc;
-
 		/* varno must not be any of OUTER_VAR, INNER_VAR and INDEX_VAR. */
 		Assert(!IS_SPECIAL_VARNO(varno));
 
-		/*
-		 * If it's a column of a foreign table, and it has the column_name FDW
-		 * option, use that value.
-		 */
-		options = GetForeignColumnOptions(rte->relid, varattno);
-		foreach(lc, options)
-		{
-			DefElem    *def = (DefElem *) lfirst(lc);
+		if (qualify_col)
+			ADD_REL_QUALIFIER(buf, varno);
 
-			if (strcmp(def->defname, "column_name") == 0)
-			{
-				colname = defGetString(def);
-				break;
-			}
+		appendStringInfoString(buf,
+							   mysql_quote_identifier(mysql_get_column_name(rte->relid,
+																			varattno),
+													  '`'));
+	}
+}
+
+/*
+ * Get the remote name of a column of a foreign table.
+ */
+char *
+mysql_get_column_name(Oid relid, int attnum)
+{
+	char	   *colname = NULL;
+	List	   *options;
+	ListCell   *lc;
+
+	/*
+	 * If it's a column of a foreign table, and it has the column_name FDW
+	 * option, use that value.
+	 */
+	options = GetForeignColumnOptions(relid, attnum);
+	foreach(lc, options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "column_name") == 0)
+		{
+			colname = defGetString(def);
+			break;
 		}
+	}
 
-		/*
-		 * If it's a column of a regular table or it doesn't have column_name
-		 * FDW option, use attribute name.
-		 */
-		if (colname == NULL)
+	/*
+	 * If it's a column of a regular table or it doesn't have column_name FDW
+	 * option, use attribute name.
+	 */
+	if (colname == NULL)
 #if PG_VERSION_NUM >= 110000
-			colname = get_attname(rte->relid, varattno, false);
+		colname = get_attname(relid, attnum, false);
 #else
-			colname = get_relid_attribute_name(rte->relid, varattno);
+		colname = get_relid_attribute_name(relid, attnum);
 #endif
-		if (qualify_col)
-			ADD_REL_QUALIFIER(buf, varno);
 
-		appendStringInfoString(buf, mysql_quote_identifier(colname, '`'));
-	}
+	return colname;
 }
 
 /*
@@ -0,0 +1,37 @@
+/* mysql_fdw/mysql_fdw--1.2--1.3.sql */
+
+/* mysql_fdw_get_connections gains the prepared statement cache counters */
+DROP FUNCTION mysql_fdw_get_connections ();
+
+CREATE FUNCTION mysql_fdw_get_connections (OUT server_name text,
+    OUT valid boolean, OUT stmt_cache_hits bigint,
+    OUT stmt_cache_misses bigint)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT PARALLEL RESTRICTED;
+
+/* Statistics of the queries sent to the foreign servers */
+CREATE FUNCTION mysql_fdw_stat_statements (OUT dbid oid,
+    OUT server_name text, OUT query text, OUT calls bigint,
+    OUT total_time double precision, OUT min_time double precision,
+    OUT max_time double precision, OUT mean_time double precision,
+    OUT rows bigint, OUT bytes bigint)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
+
+CREATE VIEW mysql_fdw_stat_statements AS
+  SELECT * FROM mysql_fdw_stat_statements();
+
+CREATE FUNCTION mysql_fdw_stat_statements_reset ()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT PARALLEL SAFE;
+
+REVOKE ALL ON FUNCTION mysql_fdw_stat_statements_reset () FROM PUBLIC;
+
+/* What the backends waiting on a MySQL connection wait for */
+CREATE FUNCTION mysql_fdw_wait_events (OUT pid integer, OUT wait_event text)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
@@ -34,6 +34,11 @@
 #endif
 #include "commands/defrem.h"
 #include "commands/explain.h"
+#if PG_VERSION_NUM >= 130000
+#include "common/hashfn.h"
+#else
+#include "access/hash.h"
+#endif
 #include "catalog/heap.h"
 #include "foreign/fdwapi.h"
 #include "miscadmin.h"
@@ -57,6 +62,7 @@
 #include "optimizer/tlist.h"
 #include "optimizer/restrictinfo.h"
 #include "parser/parsetree.h"
+#include "pgstat.h"
 #include "storage/ipc.h"
 #include "utils/builtins.h"
 #include "utils/datum.h"
@@ -91,19 +97,23 @@ int			((mysql_stmt_prepare) (MYSQL_STMT * stmt, const char *query,
 								   unsigned long length));
 int			((mysql_stmt_execute) (MYSQL_STMT * stmt));
 int			((mysql_stmt_fetch) (MYSQL_STMT * stmt));
+int			((mysql_stmt_fetch_column) (MYSQL_STMT * stmt, MYSQL_BIND * bind_arg,
+										unsigned int column,
+										unsigned long offset));
 int			((mysql_query) (MYSQL * mysql, const char *q));
 bool		((mysql_stmt_attr_set) (MYSQL_STMT * stmt,
 									enum enum_stmt_attr_type attr_type,
 									const void *attr));
 bool		((mysql_stmt_close) (MYSQL_STMT * stmt));
 bool		((mysql_stmt_reset) (MYSQL_STMT * stmt));
+bool		((mysql_stmt_free_result) (MYSQL_STMT * stmt));
 bool		((mysql_free_result) (MYSQL_RES * result));
 bool		((mysql_stmt_bind_param) (MYSQL_STMT * stmt, MYSQL_BIND * bnd));
 bool		((mysql_stmt_bind_result) (MYSQL_STMT * stmt, MYSQL_BIND * bnd));
 
 MYSQL_STMT *((mysql_stmt_init) (MYSQL * mysql));
 MYSQL_RES  *((mysql_stmt_result_metadata) (MYSQL_STMT * stmt));
-int			((mysql_stmt_store_result) (MYSQL * mysql));
+int			((mysql_stmt_store_result) (MYSQL_STMT * stmt));
 
 MYSQL_ROW((mysql_fetch_row) (MYSQL_RES * result));
 MYSQL_FIELD *((mysql_fetch_field) (MYSQL_RES * result));
@@ -130,8 +140,31 @@ unsigned int ((mysql_num_fields) (MYSQL_RES * result));
 unsigned int ((mysql_num_rows) (MYSQL_RES * result));
 unsigned int ((mysql_warning_count) (MYSQL * mysql));
 uint64_t	((mysql_stmt_affected_rows) (MYSQL_STMT * stmt));
+unsigned long ((mysql_thread_id) (MYSQL * mysql));
+int			((mysql_ping) (MYSQL * mysql));
+#ifdef MYSQL_FDW_ASYNC
+int			((mysql_stmt_execute_start) (int *ret, MYSQL_STMT * stmt));
+int			((mysql_stmt_execute_cont) (int *ret, MYSQL_STMT * stmt,
+										int ready_status));
+my_socket	((mysql_get_socket) (MYSQL * mysql));
+unsigned int ((mysql_get_timeout_value_ms) (const MYSQL * mysql));
+int			((mysql_real_query_start) (int *ret, MYSQL * mysql,
+									   const char *query,
+									   unsigned long length));
+int			((mysql_real_query_cont) (int *ret, MYSQL * mysql,
+									  int ready_status));
+
+/* Does the loaded client library have the non-blocking API? */
+bool		mysql_async_supported = false;
+#endif
 
 #define DEFAULTE_NUM_ROWS    1000
+
+/*
+ * Number of key ranges of a parallel scan per participating process, so that
+ * processes that are done early can take over more of them.
+ */
+#define MYSQL_PARALLEL_RANGES_PER_PROCESS	8
 #define MYSQL_DEFAULT_QUERY_PARAM_MAX_LIMIT 65535
 
 /*
@@ -188,6 +221,13 @@ enum mysqlFdwScanPrivateIndex
 	/* Integer list of attribute numbers retrieved by the SELECT */
 	mysqlFdwScanPrivateRetrievedAttrs,
 
+	/*
+	 * Integer list of the number of keys read at once by a batched
+	 * parameterized scan and of the attribute number of its key column, or
+	 * NIL if the scan is not batched
+	 */
+	mysqlFdwScanPrivateRescanBatch,
+
 	/*
 	 * String describing join i.e. names of relations being joined and types
 	 * of join, added when the scan is join
@@ -255,6 +295,41 @@ enum FdwDirectModifyPrivateIndex
 	FdwDirectModifyPrivateSetProcessed
 };
 
+/*
+ * A batched parameterized scan keeps reading windows of keys as long as they
+ * answer, on average, at least MYSQL_RESCAN_MIN_HITS rescans each; this is
+ * checked once MYSQL_RESCAN_MIN_WINDOWS windows have been read.
+ */
+#define MYSQL_RESCAN_MIN_WINDOWS	4
+#define MYSQL_RESCAN_MIN_HITS		2
+
+/*
+ * Rows of the window read by a batched parameterized scan that have the same
+ * key.
+ */
+typedef struct MySQLRescanEntry
+{
+	int64		key;			/* hash key (must be first) */
+	List	   *rows;			/* HeapTuples having this key */
+} MySQLRescanEntry;
+
+/*
+ * Parameter values of a rescan, as a string made of their output forms, by
+ * which the rescan cache keeps results.
+ */
+typedef struct MySQLRescanCacheKey
+{
+	char	   *data;
+	int			len;
+} MySQLRescanCacheKey;
+
+/* Complete result of a rescan kept in the rescan cache */
+typedef struct MySQLRescanCacheEntry
+{
+	MySQLRescanCacheKey key;	/* hash key (must be first) */
+	List	   *rows;			/* HeapTuples of the result */
+} MySQLRescanCacheEntry;
+
 /*
  * Struct for path_value custom type
  */
@@ -290,6 +365,27 @@ static void mysqlBeginForeignScan(ForeignScanState *node, int eflags);
 static TupleTableSlot *mysqlIterateForeignScan(ForeignScanState *node);
 static void mysqlReScanForeignScan(ForeignScanState *node);
 static void mysqlEndForeignScan(ForeignScanState *node);
+static bool mysqlIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
+										   RangeTblEntry *rte);
+static Size mysqlEstimateDSMForeignScan(ForeignScanState *node,
+										ParallelContext *pcxt);
+static void mysqlInitializeDSMForeignScan(ForeignScanState *node,
+										  ParallelContext *pcxt,
+										  void *coordinate);
+#if PG_VERSION_NUM >= 100000
+static void mysqlReInitializeDSMForeignScan(ForeignScanState *node,
+											ParallelContext *pcxt,
+											void *coordinate);
+#endif
+static void mysqlInitializeWorkerForeignScan(ForeignScanState *node,
+											 shm_toc *toc,
+											 void *coordinate);
+#ifdef MYSQL_FDW_ASYNC
+static bool mysqlIsForeignPathAsyncCapable(ForeignPath *path);
+static void mysqlForeignAsyncRequest(AsyncRequest *areq);
+static void mysqlForeignAsyncConfigureWait(AsyncRequest *areq);
+static void mysqlForeignAsyncNotify(AsyncRequest *areq);
+#endif
 
 static List *mysqlPlanForeignModify(PlannerInfo *root, ModifyTable *plan,
 									Index resultRelation, int subplan_index);
@@ -463,7 +559,10 @@ static void process_query_params(ExprContext *econtext,
 								 MYSQL_BIND * *mysql_bind_buf,
 								 Oid *param_types);
 
+static void bind_stmt_params(ForeignScanState *node);
 static void bind_stmt_params_and_exec(ForeignScanState *node);
+static void mysql_execute_scan(MySQLFdwExecState * festate);
+static void mysql_scan_executed(MySQLFdwExecState * festate);
 static void execute_dml_stmt(ForeignScanState *node);
 
 void	   *mysql_dll_handle = NULL;
@@ -471,6 +570,57 @@ static int	wait_timeout = WAIT_TIMEOUT;
 static int	interactive_timeout = INTERACTIVE_TIMEOUT;
 static void mysql_error_print(MYSQL * conn);
 static void mysql_stmt_error_print(MYSQL * conn, MYSQL_STMT * stmt, const char *msg);
+static MYSQL_STMT *mysql_prepare_stmt(MYSQL * conn, const char *query,
+									  MySQLInstrumentation *instr);
+static int	mysql_execute_stmt(MYSQL_STMT * stmt, Oid serverid,
+							   const char *query, MySQLInstrumentation *instr);
+static void mysql_scan_stat_start(MySQLFdwExecState * festate);
+static void mysql_scan_stat_end(MySQLFdwExecState * festate);
+static MySQLInstrumentation *mysql_instr_create(EState *estate);
+static void mysql_instr_accum(MySQLInstrumentation *instr, instr_time *total,
+							  instr_time start);
+static void mysql_explain_instr(MySQLInstrumentation *instr, bool is_scan,
+								ExplainState *es);
+static void mysql_set_session(MYSQL * conn, MySQLConnState *state);
+static int	mysql_startup_cost(mysql_opt * options);
+static bool mysql_query_is_read_only(PlannerInfo *root);
+static bool mysql_plan_is_read_only(EState *estate);
+static void mysql_check_warnings(MYSQL * conn);
+static int64 mysql_get_bytes_sent(MYSQL * conn);
+static void mysql_close_stream_connection(void *arg);
+static bool mysql_next_parallel_range(MySQLFdwExecState * festate);
+static double mysql_parallel_divisor(int parallel_workers);
+static RestrictInfo *mysql_rescan_batch_clause(PlannerInfo *root,
+											   RelOptInfo *baserel,
+											   List *clauses, Var **key_var,
+											   Expr **outer_expr);
+static TupleTableSlot *mysql_fetch_tuple(ForeignScanState *node);
+static bool mysql_fetch_batch(ForeignScanState *node);
+static void mysql_copy_column(mysql_column * dst, mysql_column * src);
+static int	mysql_fetch_batch_rows(mysql_table * table, int ncolumns);
+static int	mysql_bind_result_table(mysql_table * table, TupleDesc tupdesc,
+									List *retrieved_attrs);
+static TupleTableSlot *mysql_iterate_batched(ForeignScanState *node);
+static bool mysql_fetch_rescan_window(ForeignScanState *node, int64 key);
+static bool mysql_is_integer_type(Oid type);
+static bool mysql_outer_key_is_ordered(PlannerInfo *root, Expr *outer_expr);
+static bool mysql_rescan_key_is_unique(PlannerInfo *root, RelOptInfo *baserel,
+									   AttrNumber attno);
+static TupleTableSlot *mysql_iterate_cached(ForeignScanState *node);
+static void mysql_rescan_cache_key(ForeignScanState *node,
+								   MySQLRescanCacheKey *key);
+static void mysql_rescan_cache_drop_fill(MySQLFdwExecState * festate);
+static uint32 mysql_rescan_cache_hash(const void *key, Size keysize);
+static int	mysql_rescan_cache_match(const void *key1, const void *key2,
+									 Size keysize);
+static int64 mysql_integer_datum(Datum value, Oid type);
+#ifdef MYSQL_FDW_ASYNC
+static void mysql_begin_async_execute(AsyncRequest *areq);
+static void mysql_end_async_execute(ForeignScanState *node);
+static void mysql_discard_async_execute(ForeignScanState *node);
+static void mysql_process_pending_request(AsyncRequest *areq);
+static void mysql_complete_pending_request(MYSQL * conn);
+#endif
 static List *getUpdateTargetAttrs(RangeTblEntry *rte);
 
 static bool foreign_join_ok(PlannerInfo *root, RelOptInfo *joinrel,
@@ -548,6 +698,7 @@ mysql_load_library(void)
 	_mysql_stmt_prepare = dlsym(mysql_dll_handle, "mysql_stmt_prepare");
 	_mysql_stmt_execute = dlsym(mysql_dll_handle, "mysql_stmt_execute");
 	_mysql_stmt_fetch = dlsym(mysql_dll_handle, "mysql_stmt_fetch");
+	_mysql_stmt_fetch_column = dlsym(mysql_dll_handle, "mysql_stmt_fetch_column");
 	_mysql_query = dlsym(mysql_dll_handle, "mysql_query");
 	_mysql_stmt_result_metadata = dlsym(mysql_dll_handle, "mysql_stmt_result_metadata");
 	_mysql_stmt_store_result = dlsym(mysql_dll_handle, "mysql_stmt_store_result");
@@ -556,6 +707,7 @@ mysql_load_library(void)
 	_mysql_fetch_fields = dlsym(mysql_dll_handle, "mysql_fetch_fields");
 	_mysql_stmt_close = dlsym(mysql_dll_handle, "mysql_stmt_close");
 	_mysql_stmt_reset = dlsym(mysql_dll_handle, "mysql_stmt_reset");
+	_mysql_stmt_free_result = dlsym(mysql_dll_handle, "mysql_stmt_free_result");
 	_mysql_free_result = dlsym(mysql_dll_handle, "mysql_free_result");
 	_mysql_error = dlsym(mysql_dll_handle, "mysql_error");
 	_mysql_options = dlsym(mysql_dll_handle, "mysql_options");
@@ -574,6 +726,16 @@ mysql_load_library(void)
 	_mysql_get_proto_info = dlsym(mysql_dll_handle, "mysql_get_proto_info");
 	_mysql_warning_count = dlsym(mysql_dll_handle, "mysql_warning_count");
 	_mysql_stmt_affected_rows = dlsym(mysql_dll_handle, "mysql_stmt_affected_rows");
+	_mysql_thread_id = dlsym(mysql_dll_handle, "mysql_thread_id");
+	_mysql_ping = dlsym(mysql_dll_handle, "mysql_ping");
+#ifdef MYSQL_FDW_ASYNC
+	_mysql_stmt_execute_start = dlsym(mysql_dll_handle, "mysql_stmt_execute_start");
+	_mysql_stmt_execute_cont = dlsym(mysql_dll_handle, "mysql_stmt_execute_cont");
+	_mysql_get_socket = dlsym(mysql_dll_handle, "mysql_get_socket");
+	_mysql_get_timeout_value_ms = dlsym(mysql_dll_handle, "mysql_get_timeout_value_ms");
+	_mysql_real_query_start = dlsym(mysql_dll_handle, "mysql_real_query_start");
+	_mysql_real_query_cont = dlsym(mysql_dll_handle, "mysql_real_query_cont");
+#endif
 
 	if (_mysql_stmt_bind_param == NULL ||
 		_mysql_stmt_bind_result == NULL ||
@@ -581,6 +743,7 @@ mysql_load_library(void)
 		_mysql_stmt_prepare == NULL ||
 		_mysql_stmt_execute == NULL ||
 		_mysql_stmt_fetch == NULL ||
+		_mysql_stmt_fetch_column == NULL ||
 		_mysql_query == NULL ||
 		_mysql_stmt_result_metadata == NULL ||
 		_mysql_stmt_store_result == NULL ||
@@ -589,6 +752,7 @@ mysql_load_library(void)
 		_mysql_fetch_fields == NULL ||
 		_mysql_stmt_close == NULL ||
 		_mysql_stmt_reset == NULL ||
+		_mysql_stmt_free_result == NULL ||
 		_mysql_free_result == NULL ||
 		_mysql_error == NULL ||
 		_mysql_options == NULL ||
@@ -606,9 +770,26 @@ mysql_load_library(void)
 		_mysql_get_server_info == NULL ||
 		_mysql_get_proto_info == NULL ||
 		_mysql_warning_count == NULL ||
-		_mysql_stmt_affected_rows == NULL)
+		_mysql_stmt_affected_rows == NULL ||
+		_mysql_thread_id == NULL ||
+		_mysql_ping == NULL)
 		return false;
 
+#ifdef MYSQL_FDW_ASYNC
+
+	/*
+	 * The non-blocking API is optional; without it, foreign scans are never
+	 * run asynchronously and remote transactions are ended one after the
+	 * other.
+	 */
+	mysql_async_supported = (_mysql_stmt_execute_start != NULL &&
+							 _mysql_stmt_execute_cont != NULL &&
+							 _mysql_get_socket != NULL &&
+							 _mysql_get_timeout_value_ms != NULL &&
+							 _mysql_real_query_start != NULL &&
+							 _mysql_real_query_cont != NULL);
+#endif
+
 	return true;
 }
 
@@ -653,6 +834,8 @@ _PG_init(void)
 							NULL,
 							NULL);
 
+	mysql_stat_init();
+
 	on_proc_exit(&mysql_fdw_exit, PointerGetDatum(NULL));
 }
 
@@ -733,6 +916,23 @@ mysql_fdw_handler(PG_FUNCTION_ARGS)
 	/* Support functions for upper relation push-down */
 	fdwroutine->GetForeignUpperPaths = mysqlGetForeignUpperPaths;
 
+	/* Support functions for parallel scans */
+	fdwroutine->IsForeignScanParallelSafe = mysqlIsForeignScanParallelSafe;
+	fdwroutine->EstimateDSMForeignScan = mysqlEstimateDSMForeignScan;
+	fdwroutine->InitializeDSMForeignScan = mysqlInitializeDSMForeignScan;
+#if PG_VERSION_NUM >= 100000
+	fdwroutine->ReInitializeDSMForeignScan = mysqlReInitializeDSMForeignScan;
+#endif
+	fdwroutine->InitializeWorkerForeignScan = mysqlInitializeWorkerForeignScan;
+
+#ifdef MYSQL_FDW_ASYNC
+	/* Support functions for asynchronous execution */
+	fdwroutine->IsForeignPathAsyncCapable = mysqlIsForeignPathAsyncCapable;
+	fdwroutine->ForeignAsyncRequest = mysqlForeignAsyncRequest;
+	fdwroutine->ForeignAsyncConfigureWait = mysqlForeignAsyncConfigureWait;
+	fdwroutine->ForeignAsyncNotify = mysqlForeignAsyncNotify;
+#endif
+
 	PG_RETURN_POINTER(fdwroutine);
 }
 
@@ -751,17 +951,16 @@ mysqlBeginForeignScan(ForeignScanState *node, int eflags)
 	EState	   *estate = node->ss.ps.state;
 	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
 	mysql_opt  *options;
-	ListCell   *lc;
-	int			atindex = 0;
 	unsigned long type = (unsigned long) CURSOR_TYPE_READ_ONLY;
 	Oid			userid;
 	ForeignServer *server;
 	UserMapping *user;
 	ForeignTable *table;
-	char		timeout[255];
 	int			numParams;
+	int			ncolumns;
 	int			rtindex;
 	List	   *fdw_private = fsplan->fdw_private;
+	List	   *rescan_batch;
 
 	/*
 	 * Do nothing in EXPLAIN (no ANALYZE) case. node->fdw_state stays NULL.
@@ -774,6 +973,7 @@ mysqlBeginForeignScan(ForeignScanState *node, int eflags)
 	 */
 	festate = (MySQLFdwExecState *) palloc0(sizeof(MySQLFdwExecState));
 	node->fdw_state = (void *) festate;
+	festate->instr = mysql_instr_create(estate);
 
 	/*
 	 * If whole-row references are involved in pushed down join extract the
@@ -817,53 +1017,101 @@ mysqlBeginForeignScan(ForeignScanState *node, int eflags)
 	/* Fetch the options */
 	options = mysql_get_options(rte->relid, true);
 
+	festate->mysqlFdwOptions = options;
+	festate->scan_mode = options->scan_mode;
+	festate->serverid = server->serverid;
+
 	/*
-	 * Get the already connected connection, otherwise connect and get the
-	 * connection handle.
+	 * A stream scan keeps its result pending on the connection until all
+	 * rows are read, so it takes a private connection from the pool, which
+	 * it gives back when the scan ends, or when the query's memory goes away
+	 * on error.  Such a scan runs in a remote transaction of its own, which
+	 * does not see the changes made by the local transaction, so once that
+	 * has written to the server the scan reads through a cursor instead.
+	 * Otherwise, get the already connected connection, or connect and get
+	 * the connection handle.
 	 */
-	conn = mysql_get_connection(server, user, options);
+	if (festate->scan_mode == MYSQL_SCAN_MODE_STREAM &&
+		mysql_xact_wrote(server, user))
+		festate->scan_mode = MYSQL_SCAN_MODE_CURSOR;
+	if (festate->scan_mode == MYSQL_SCAN_MODE_STREAM)
+	{
+		conn = mysql_get_private_connection(server, user, options,
+											mysql_plan_is_read_only(estate));
+		festate->conn = conn;
+		festate->conn_cb.func = mysql_close_stream_connection;
+		festate->conn_cb.arg = (void *) festate;
+		MemoryContextRegisterResetCallback(estate->es_query_cxt,
+										   &festate->conn_cb);
+	}
+	else
+		conn = mysql_get_connection(server, user, options,
+									mysql_plan_is_read_only(estate));
+	festate->conn_state = mysql_get_conn_state(conn);
 
 	/* Stash away the state info we have already */
 	festate->query = strVal(list_nth(fsplan->fdw_private,
 									 mysqlFdwScanPrivateSelectSql));
 	festate->retrieved_attrs = list_nth(fsplan->fdw_private,
 										mysqlFdwScanPrivateRetrievedAttrs);
+	rescan_batch = list_nth(fsplan->fdw_private,
+							mysqlFdwScanPrivateRescanBatch);
 	festate->conn = conn;
 	festate->query_executed = false;
 	festate->attinmeta = TupleDescGetAttInMetadata(tupleDescriptor);
 
-	if (wait_timeout > 0)
-	{
-		/* Set the session timeout in seconds */
-		sprintf(timeout, "SET wait_timeout = %d", wait_timeout);
-		mysql_query(festate->conn, timeout);
-	}
+	/* The query of a parallel scan reads a range of keys at a time */
+	festate->is_parallel = fsplan->scan.plan.parallel_aware;
 
-	if (interactive_timeout > 0)
+	/*
+	 * The query of a batched parameterized scan reads a window of keys at a
+	 * time.  Its key is the last parameter of the plan, which is evaluated
+	 * separately as it is not passed to the query.
+	 */
+	if (rescan_batch != NIL)
 	{
-		/* Set the session timeout in seconds */
-		sprintf(timeout, "SET interactive_timeout = %d", interactive_timeout);
-		mysql_query(festate->conn, timeout);
+		Expr	   *key_expr = (Expr *) llast(fsplan->fdw_exprs);
+
+		festate->rescan_batch_size = linitial_int(rescan_batch);
+		festate->rescan_key_attno = lsecond_int(rescan_batch);
+		festate->rescan_key_type = exprType((Node *) key_expr);
+		festate->rescan_key_expr = ExecInitExpr(key_expr, (PlanState *) node);
+		festate->rescan_cxt = AllocSetContextCreate(estate->es_query_cxt,
+													"mysql_fdw rescan window",
+													ALLOCSET_DEFAULT_SIZES);
 	}
 
-	/* Change sql_mode to TRADITIONAL to catch warning "Division by 0" */
-	mysql_query(festate->conn, "SET sql_mode='TRADITIONAL'");
+	/*
+	 * Create context for per-tuple temp workspace.  It is reset before each
+	 * batch of rows is fetched, so memory used by a scan does not grow with
+	 * the rows read.
+	 */
+	festate->temp_cxt = AllocSetContextCreate(estate->es_query_cxt,
+											  "mysql_fdw temporary data",
+											  ALLOCSET_SMALL_SIZES);
+
+	/* Set the session timeouts and sql_mode */
+	mysql_set_session(festate->conn, festate->conn_state);
 
-	/* Initialize the MySQL statement */
-	festate->stmt = mysql_stmt_init(festate->conn);
-	if (festate->stmt == NULL)
-		ereport(ERROR,
-				(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
-				 errmsg("failed to initialize the mysql query: \n%s",
-						mysql_error(festate->conn))));
+	/*
+	 * Under EXPLAIN ANALYZE, note what the server has sent on a compressed
+	 * connection so far, to tell the compressed size of what the scan reads.
+	 */
+	if (festate->instr && options->compression != MYSQL_COMPRESSION_OFF)
+	{
+		festate->instr->compressed = true;
+		festate->instr->bytes_sent_start = mysql_get_bytes_sent(festate->conn);
+		festate->instr->bytes_received = -1;
+	}
 
-	/* Prepare MySQL statement */
-	if (mysql_stmt_prepare(festate->stmt, festate->query,
-						   strlen(festate->query)) != 0)
-		mysql_stmt_error_print(festate->conn, festate->stmt, "failed to prepare the MySQL query");
+	/* Get the prepared MySQL statement */
+	festate->stmt = mysql_prepare_stmt(festate->conn, festate->query,
+									   festate->instr);
 
 	/* Prepare for output conversion of parameters used in remote query. */
 	numParams = list_length(fsplan->fdw_exprs);
+	if (festate->rescan_batch_size > 0)
+		numParams--;
 	festate->numParams = numParams;
 	if (numParams > 0)
 		prepare_query_params((PlanState *) node,
@@ -874,18 +1122,35 @@ mysqlBeginForeignScan(ForeignScanState *node, int eflags)
 							 &festate->param_values,
 							 &festate->param_types);
 
+	/*
+	 * A parameterized scan may keep the rows of its rescans, to replay them
+	 * to a later rescan with the same parameter values.
+	 */
+	if (options->rescan_cache && numParams > 0 &&
+		festate->rescan_batch_size == 0)
+		festate->rescan_cache_cxt = AllocSetContextCreate(estate->es_query_cxt,
+														  "mysql_fdw rescan cache",
+														  ALLOCSET_DEFAULT_SIZES);
+
 	/* int column_count = mysql_num_fields(festate->meta); */
 
-	/* Set the statement as cursor type */
-	mysql_stmt_attr_set(festate->stmt, STMT_ATTR_CURSOR_TYPE, (void *) &type);
+	/*
+	 * Set the statement as cursor type, or not, as a cached statement keeps
+	 * the attributes set by its previous user.
+	 */
+	if (festate->scan_mode != MYSQL_SCAN_MODE_CURSOR)
+		type = (unsigned long) CURSOR_TYPE_NO_CURSOR;
+	mysql_stmt_attr_set(festate->stmt, STMT_ATTR_CURSOR_TYPE,
+						(void *) &type);
 
-	/* Set the pre-fetch rows */
-	mysql_stmt_attr_set(festate->stmt, STMT_ATTR_PREFETCH_ROWS,
-						(void *) &options->fetch_size);
+	if (festate->scan_mode == MYSQL_SCAN_MODE_CURSOR)
+	{
+		/* Set the pre-fetch rows */
+		mysql_stmt_attr_set(festate->stmt, STMT_ATTR_PREFETCH_ROWS,
+							(void *) &options->fetch_size);
+	}
 
 	festate->table = (mysql_table *) palloc0(sizeof(mysql_table));
-	festate->table->column = (mysql_column *) palloc0(sizeof(mysql_column) * tupleDescriptor->natts);
-	festate->table->mysql_bind = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * tupleDescriptor->natts);
 
 	festate->table->mysql_res = mysql_stmt_result_metadata(festate->stmt);
 	if (NULL == festate->table->mysql_res)
@@ -894,227 +1159,1828 @@ mysqlBeginForeignScan(ForeignScanState *node, int eflags)
 				 errmsg("failed to retrieve query result set metadata: \n%s",
 						mysql_error(festate->conn))));
 
-	festate->table->mysql_fields = mysql_fetch_fields(festate->table->mysql_res);
+	festate->table->mysql_fields = mysql_fetch_fields(festate->table->mysql_res);
+
+	ncolumns = mysql_bind_result_table(festate->table, tupleDescriptor,
+									   festate->retrieved_attrs);
+
+	/*
+	 * Rows are fetched in batches, so that their values can be converted a
+	 * column at a time.  Each row is fetched into the buffers bound to the
+	 * statement, and its values copied to buffers of its own in the batch.
+	 */
+	festate->fetch_batch = mysql_fetch_batch_rows(festate->table, ncolumns);
+	if (festate->fetch_batch == 1)
+		festate->fetch_tables = festate->table;
+	else
+	{
+		int			row;
+
+		festate->fetch_tables = (mysql_table *) palloc0(sizeof(mysql_table) *
+														festate->fetch_batch);
+
+		for (row = 0; row < festate->fetch_batch; row++)
+		{
+			mysql_table *table = &festate->fetch_tables[row];
+
+			table->mysql_res = festate->table->mysql_res;
+			table->mysql_fields = festate->table->mysql_fields;
+			(void) mysql_bind_result_table(table, tupleDescriptor,
+										   festate->retrieved_attrs);
+		}
+	}
+
+	festate->fetch_values = (Datum *) palloc0(sizeof(Datum) * festate->fetch_batch *
+											  tupleDescriptor->natts);
+	festate->fetch_nulls = (bool *) palloc(sizeof(bool) * festate->fetch_batch *
+										   tupleDescriptor->natts);
+	festate->fetch_converted = (bool *) palloc(sizeof(bool) * festate->fetch_batch *
+											   tupleDescriptor->natts);
+
+	/* Bind the results pointers for the prepare statements */
+	if (mysql_stmt_bind_result(festate->stmt, festate->table->mysql_bind) != 0)
+		mysql_stmt_error_print(festate->conn, festate->stmt, "failed to bind the MySQL query");
+}
+
+/*
+ * mysqlIterateForeignScan
+ * 		Iterate and get the rows one by one from  MySQL and placed in tuple
+ * 		slot
+ */
+static TupleTableSlot *
+mysqlIterateForeignScan(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+
+	/* A batched parameterized scan answers rescans from its window of keys */
+	if (festate->rescan_batch_size > 0)
+		return mysql_iterate_batched(node);
+
+	/* Rescans may replay the rows of an earlier one with the same params */
+	if (festate->rescan_cache_cxt)
+		return mysql_iterate_cached(node);
+
+	return mysql_fetch_tuple(node);
+}
+
+/*
+ * mysql_fetch_tuple
+ * 		Fetch the next row of the scan's query into the tuple slot, executing
+ * 		the query first if needed
+ *
+ * Rows are fetched a batch at a time by mysql_fetch_batch(), and handed out
+ * one by one from the values it converted.
+ */
+static TupleTableSlot *
+mysql_fetch_tuple(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	TupleTableSlot *tupleSlot = node->ss.ss_ScanTupleSlot;
+	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
+	List	   *fdw_private = fsplan->fdw_private;
+	bool		has_whole_row = list_length(fdw_private) >= mysqlFdwPrivateScanTList;
+	int			natts = festate->attinmeta->tupdesc->natts;
+	Datum	   *dvalues;
+	bool	   *nulls;
+	HeapTuple	tup;
+	MemoryContext oldcontext;
+
+	/*
+	 * The previous row may point to the values of the batch, so release the
+	 * slot's reference to it before fetching the next batch.
+	 */
+	ExecClearTuple(tupleSlot);
+
+	if (festate->fetch_next >= festate->fetched_rows &&
+		!mysql_fetch_batch(node))
+		return tupleSlot;
+
+	dvalues = &festate->fetch_values[festate->fetch_next * natts];
+	nulls = &festate->fetch_nulls[festate->fetch_next * natts];
+	festate->fetch_next++;
+
+	/*
+	 * Fill the scan slot's arrays and store it as a virtual tuple, unless
+	 * whole-row references need a tuple to be constructed.
+	 */
+	if (!has_whole_row)
+	{
+		memcpy(tupleSlot->tts_values, dvalues, natts * sizeof(Datum));
+		memcpy(tupleSlot->tts_isnull, nulls, natts * sizeof(bool));
+		ExecStoreVirtualTuple(tupleSlot);
+		return tupleSlot;
+	}
+
+	/* Construct tuple with whole-row references. */
+	oldcontext = MemoryContextSwitchTo(festate->temp_cxt);
+	tup = mysql_get_tuple_with_whole_row(festate, dvalues, nulls);
+	MemoryContextSwitchTo(oldcontext);
+
+#if PG_VERSION_NUM >= 120000
+	ExecStoreHeapTuple(tup, tupleSlot, false);
+#else
+	ExecStoreTuple(tup, tupleSlot, InvalidBuffer, false);
+#endif
+
+	return tupleSlot;
+}
+
+/*
+ * mysql_fetch_batch
+ * 		Fetch the next batch of rows of the scan's query, and convert their
+ * 		values
+ *
+ * Each row is fetched into the buffers bound to the statement once for the
+ * scan.  Values that have to be fetched again in full are converted right
+ * away, as that is only possible while their row is the current one.  All
+ * others are copied to the buffers of their row in the batch, and converted
+ * once the batch is complete, a column at a time, so that each converter is
+ * called for all the rows of the batch in a row.
+ *
+ * Returns false if no row is left.
+ */
+static bool
+mysql_fetch_batch(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	int			natts = festate->attinmeta->tupdesc->natts;
+	int			nrows = 0;
+	int			row;
+	int			attid;
+	ListCell   *lc;
+	MemoryContext oldcontext;
+	instr_time	start;
+
+	INSTR_TIME_SET_ZERO(start);
+
+	/* Values of the previous batch are not referenced anymore */
+	MemoryContextReset(festate->temp_cxt);
+	festate->fetched_rows = 0;
+	festate->fetch_next = 0;
+
+#ifdef MYSQL_FDW_ASYNC
+
+	/*
+	 * A query executing asynchronously on the connection, for this scan or
+	 * for another one sharing the connection, has to finish first.
+	 */
+	if (festate->conn_state && festate->conn_state->pending_areq)
+	{
+		AsyncRequest *pending_areq = festate->conn_state->pending_areq;
+
+		if (pending_areq->requestee != (PlanState *) node)
+			mysql_process_pending_request(pending_areq);
+		else
+		{
+			mysql_finish_async_execute(festate->conn_state, true);
+			mysql_end_async_execute(node);
+		}
+	}
+#endif
+
+	oldcontext = MemoryContextSwitchTo(festate->temp_cxt);
+
+	while (nrows < festate->fetch_batch)
+	{
+		mysql_table *table = &festate->fetch_tables[nrows];
+		Datum	   *dvalues = &festate->fetch_values[nrows * natts];
+		bool	   *nulls = &festate->fetch_nulls[nrows * natts];
+		bool	   *converted = &festate->fetch_converted[nrows * natts];
+		int64		row_bytes = 0;
+		int			rc;
+
+		/*
+		 * If this is the first call after Begin or ReScan, we need to bind
+		 * the params and execute the query.  A parallel scan executes it
+		 * again for each range of keys it gets, until none is left.
+		 */
+		if (!festate->query_executed)
+		{
+			if (festate->is_parallel && !mysql_next_parallel_range(festate))
+				break;
+
+			bind_stmt_params_and_exec(node);
+		}
+
+		if (festate->instr && festate->instr->need_timer)
+			INSTR_TIME_SET_CURRENT(start);
+
+		pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_FETCH));
+		rc = mysql_stmt_fetch(festate->stmt);
+		pgstat_report_wait_end();
+
+		if (festate->instr && festate->instr->need_timer)
+			mysql_instr_accum(festate->instr, &festate->instr->fetch_time,
+							  start);
+
+		if (rc == 1)
+		{
+			/*
+			 * Error occurred. Error code and message can be obtained by
+			 * calling mysql_stmt_errno() and mysql_stmt_error().
+			 */
+			mysql_stmt_error_print(festate->conn, festate->stmt,
+								   "failed to fetch the MySQL query result");
+		}
+		else if (rc == MYSQL_NO_DATA)
+		{
+			/*
+			 * No more rows/data exists, and the server has closed the cursor
+			 * of a cursor scan.  Warnings of a stream scan can only be
+			 * checked now that its result has been read entirely.
+			 */
+			festate->cursor_open = false;
+			if (festate->scan_mode == MYSQL_SCAN_MODE_STREAM)
+			{
+				festate->rows_pending = false;
+				mysql_check_warnings(festate->conn);
+			}
+
+			mysql_scan_stat_end(festate);
+
+			if (!festate->is_parallel)
+				break;
+
+			festate->query_executed = false;
+			continue;
+		}
+
+		/*
+		 * A cursor asks the server for the next rows once the ones it
+		 * prefetched are read.  Only the fetch of the first row of a batch
+		 * is counted, as the final one finding no row left is answered by
+		 * the client library alone once the server flagged its last rows.
+		 */
+		if (festate->instr &&
+			festate->scan_mode == MYSQL_SCAN_MODE_CURSOR &&
+			festate->instr->result_rows %
+			Max(festate->mysqlFdwOptions->fetch_size, 1) == 0)
+			festate->instr->round_trips++;
+
+		/* Initialize to nulls for any columns not present in result */
+		memset(nulls, true, natts * sizeof(bool));
+		memset(converted, false, natts * sizeof(bool));
+
+		attid = 0;
+		foreach(lc, festate->retrieved_attrs)
+		{
+			int			attnum = lfirst_int(lc) - 1;
+			mysql_column *column = &festate->table->column[attid];
+
+			nulls[attnum] = column->is_null;
+
+			if (!column->is_null)
+				row_bytes += column->length;
+
+			/*
+			 * Values longer than the bind buffer sized from the metadata are
+			 * fetched again in full, like TEXT and BLOB values, which have
+			 * no bind buffer.
+			 */
+			if (!column->is_null &&
+				(column->is_lob ||
+				 (rc == MYSQL_DATA_TRUNCATED &&
+				  column->length > column->mysql_bind->buffer_length)))
+			{
+				if (festate->instr && festate->instr->need_timer)
+					INSTR_TIME_SET_CURRENT(start);
+
+				dvalues[attnum] = mysql_convert_truncated_to_pg(festate->stmt,
+																attid,
+																column);
+				converted[attnum] = true;
+
+				if (festate->instr && festate->instr->need_timer)
+					mysql_instr_accum(festate->instr,
+									  &festate->instr->convert_time, start);
+			}
+			else if (!column->is_null && table != festate->table)
+				mysql_copy_column(&table->column[attid], column);
+
+			attid++;
+		}
+
+		if (festate->instr)
+		{
+			festate->instr->rows++;
+			festate->instr->result_rows++;
+			festate->instr->bytes += row_bytes;
+		}
+
+		if (festate->stat_pending)
+		{
+			festate->stat_rows++;
+			festate->stat_bytes += row_bytes;
+		}
+
+		nrows++;
+	}
+
+	/* Convert the other values a column at a time */
+	if (festate->instr && festate->instr->need_timer)
+		INSTR_TIME_SET_CURRENT(start);
+
+	attid = 0;
+	foreach(lc, festate->retrieved_attrs)
+	{
+		int			attnum = lfirst_int(lc) - 1;
+
+		for (row = 0; row < nrows; row++)
+		{
+			int			i = row * natts + attnum;
+
+			if (!festate->fetch_nulls[i] && !festate->fetch_converted[i])
+				festate->fetch_values[i] =
+					mysql_convert_to_pg(&festate->fetch_tables[row].column[attid]);
+		}
+
+		attid++;
+	}
+
+	if (festate->instr && festate->instr->need_timer)
+		mysql_instr_accum(festate->instr, &festate->instr->convert_time,
+						  start);
+
+	MemoryContextSwitchTo(oldcontext);
+
+	festate->fetched_rows = nrows;
+
+	return nrows > 0;
+}
+
+/*
+ * mysql_fetch_batch_rows
+ * 		Number of rows a scan fetches in a batch, given the columns bound for
+ * 		one row
+ *
+ * The bind buffers of a batch are kept within MYSQL_FETCH_BATCH_BYTES.  A
+ * scan of TEXT or BLOB columns fetches a row at a time, so as not to hold
+ * several large values at once.
+ */
+static int
+mysql_fetch_batch_rows(mysql_table * table, int ncolumns)
+{
+	Size		width = 0;
+	int			i;
+
+	for (i = 0; i < ncolumns; i++)
+	{
+		if (table->column[i].is_lob)
+			return 1;
+
+		width += table->mysql_bind[i].buffer_length + VARHDRSZ + 1;
+	}
+
+	return Max(1, Min(MYSQL_FETCH_BATCH_ROWS,
+					  MYSQL_FETCH_BATCH_BYTES / Max(width, 1)));
+}
+
+/*
+ * mysql_copy_column
+ * 		Copy the value of a column fetched into the buffers bound to the
+ * 		statement to the buffers of its row in a batch
+ *
+ * Only values that fit in their bind buffer are copied; others are converted
+ * while their row is the current one.
+ */
+static void
+mysql_copy_column(mysql_column * dst, mysql_column * src)
+{
+	MYSQL_BIND *mbind = dst->mysql_bind;
+	unsigned long length = Min(src->length, mbind->buffer_length);
+
+	dst->is_null = src->is_null;
+	dst->error = src->error;
+	dst->length = src->length;
+
+	memcpy(mbind->buffer, src->mysql_bind->buffer, length);
+
+	/* Text values are terminated, like the client library does */
+	if (mbind->buffer_type == MYSQL_TYPE_VAR_STRING)
+		((char *) mbind->buffer)[length] = '\0';
+}
+
+/*
+ * mysql_bind_result_table
+ * 		Set up the buffers bound to the statement, or those of one row of a
+ * 		batch, for the columns retrieved by the scan
+ *
+ * Returns the number of columns bound.
+ */
+static int
+mysql_bind_result_table(mysql_table * table, TupleDesc tupdesc,
+						List *retrieved_attrs)
+{
+	ListCell   *lc;
+	int			atindex = 0;
+
+	table->column = (mysql_column *) palloc0(sizeof(mysql_column) * tupdesc->natts);
+	table->mysql_bind = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * tupdesc->natts);
+
+	foreach(lc, retrieved_attrs)
+	{
+		int			attnum = lfirst_int(lc) - 1;
+		Oid			pgtype = TupleDescAttr(tupdesc, attnum)->atttypid;
+		int32		pgtypmod = TupleDescAttr(tupdesc, attnum)->atttypmod;
+
+		if (TupleDescAttr(tupdesc, attnum)->attisdropped)
+			continue;
+
+		table->column[atindex].mysql_bind = &table->mysql_bind[atindex];
+
+		mysql_bind_result(pgtype, pgtypmod,
+						  &table->mysql_fields[atindex],
+						  &table->column[atindex]);
+		atindex++;
+	}
+
+	return atindex;
+}
+
+/*
+ * mysql_iterate_batched
+ * 		Return the next row having the key of the current rescan of a batched
+ * 		parameterized scan
+ *
+ * The first call of a rescan evaluates its key.  Unless the key lies in the
+ * window of keys read last, the rows of the window starting at that key are
+ * read first.
+ *
+ * Batching is given up for the rest of the scan once a window outgrows
+ * work_mem, or once windows turn out to answer too few rescans, as when the
+ * keys do not come in ascending order.  Each rescan then reads the rows of
+ * its own key, which are returned as they are fetched.
+ */
+static TupleTableSlot *
+mysql_iterate_batched(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	TupleTableSlot *tupleSlot = node->ss.ss_ScanTupleSlot;
+	HeapTuple	tup;
+
+	if (!festate->rescan_started)
+	{
+		ExprContext *econtext = node->ss.ps.ps_ExprContext;
+		MySQLRescanEntry *entry;
+		Datum		value;
+		bool		isnull;
+		int64		key;
+
+		festate->rescan_started = true;
+		festate->rescan_list = NIL;
+		festate->rescan_next = 0;
+
+#if PG_VERSION_NUM >= 100000
+		value = ExecEvalExpr(festate->rescan_key_expr, econtext, &isnull);
+#else
+		value = ExecEvalExpr(festate->rescan_key_expr, econtext, &isnull,
+							 NULL);
+#endif
+
+		/* No row is equal to a NULL key */
+		if (isnull)
+			return ExecClearTuple(tupleSlot);
+
+		key = mysql_integer_datum(value, festate->rescan_key_type);
+
+		if (!festate->rescan_unbatched)
+		{
+			if (festate->rescan_rows == NULL ||
+				key < festate->rescan_lo || key > festate->rescan_hi)
+			{
+				if (festate->rescan_windows >= MYSQL_RESCAN_MIN_WINDOWS &&
+					festate->rescan_hits <
+					festate->rescan_windows * MYSQL_RESCAN_MIN_HITS)
+				{
+					elog(DEBUG1, "mysql_fdw: " INT64_FORMAT " rescan windows answered " INT64_FORMAT " rescans, reading a key per rescan",
+						 festate->rescan_windows, festate->rescan_hits);
+					festate->rescan_unbatched = true;
+				}
+				else if (!mysql_fetch_rescan_window(node, key))
+				{
+					elog(DEBUG1, "mysql_fdw: rescan window exceeds work_mem, reading a key per rescan");
+					festate->rescan_unbatched = true;
+				}
+			}
+		}
+
+		if (festate->rescan_unbatched)
+		{
+			/* Drop the last window, and read the rows of this key alone */
+			if (festate->rescan_rows != NULL)
+			{
+				MemoryContextReset(festate->rescan_cxt);
+				festate->rescan_rows = NULL;
+			}
+
+			festate->rescan_lo = key;
+			festate->rescan_hi = key;
+			festate->query_executed = false;
+			festate->fetched_rows = 0;
+			festate->fetch_next = 0;
+		}
+		else
+		{
+			festate->rescan_hits++;
+			entry = (MySQLRescanEntry *) hash_search(festate->rescan_rows,
+													 &key, HASH_FIND, NULL);
+			if (entry)
+				festate->rescan_list = entry->rows;
+		}
+	}
+
+	if (festate->rescan_unbatched)
+		return mysql_fetch_tuple(node);
+
+	if (festate->rescan_next >= list_length(festate->rescan_list))
+		return ExecClearTuple(tupleSlot);
+
+	tup = (HeapTuple) list_nth(festate->rescan_list, festate->rescan_next++);
+
+	/* The tuple belongs to the window, so the slot must not free it */
+#if PG_VERSION_NUM >= 120000
+	ExecStoreHeapTuple(tup, tupleSlot, false);
+#else
+	ExecStoreTuple(tup, tupleSlot, InvalidBuffer, false);
+#endif
+
+	return tupleSlot;
+}
+
+/*
+ * mysql_fetch_rescan_window
+ * 		Read the rows of the window of keys starting at the given one, and
+ * 		group them by key
+ *
+ * The rows of the previous window are released first.  Returns false, with
+ * no window left, if the rows of the window take more than work_mem.
+ */
+static bool
+mysql_fetch_rescan_window(ForeignScanState *node, int64 key)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	HASHCTL		ctl;
+	TupleTableSlot *slot;
+
+	MemoryContextReset(festate->rescan_cxt);
+	festate->rescan_bytes = 0;
+	festate->rescan_windows++;
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(int64);
+	ctl.entrysize = sizeof(MySQLRescanEntry);
+	ctl.hash = tag_hash;
+	ctl.hcxt = festate->rescan_cxt;
+	festate->rescan_rows = hash_create("mysql_fdw rescan window",
+									   festate->rescan_batch_size, &ctl,
+									   HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+	festate->rescan_lo = key;
+	if (key > PG_INT64_MAX - (festate->rescan_batch_size - 1))
+		festate->rescan_hi = PG_INT64_MAX;
+	else
+		festate->rescan_hi = key + (festate->rescan_batch_size - 1);
+
+	/* Execute the query for the new window, and read all its rows */
+	festate->query_executed = false;
+	festate->fetched_rows = 0;
+	festate->fetch_next = 0;
+
+	while (!TupIsNull(slot = mysql_fetch_tuple(node)))
+	{
+		MySQLRescanEntry *entry;
+		MemoryContext oldcontext;
+		Datum		value;
+		bool		isnull;
+		int64		rowkey;
+		bool		found;
+		HeapTuple	tup;
+
+		value = slot_getattr(slot, festate->rescan_key_attno, &isnull);
+		if (isnull)
+			continue;
+
+		rowkey = mysql_integer_datum(value,
+									 TupleDescAttr(slot->tts_tupleDescriptor,
+												   festate->rescan_key_attno - 1)->atttypid);
+
+		entry = (MySQLRescanEntry *) hash_search(festate->rescan_rows,
+												 &rowkey, HASH_ENTER, &found);
+		if (!found)
+			entry->rows = NIL;
+
+		oldcontext = MemoryContextSwitchTo(festate->rescan_cxt);
+#if PG_VERSION_NUM >= 120000
+		tup = ExecCopySlotHeapTuple(slot);
+#else
+		tup = ExecCopySlotTuple(slot);
+#endif
+		entry->rows = lappend(entry->rows, tup);
+		MemoryContextSwitchTo(oldcontext);
+
+		festate->rescan_bytes += HEAPTUPLESIZE + tup->t_len +
+			sizeof(ListCell);
+		if (!found)
+			festate->rescan_bytes += sizeof(MySQLRescanEntry);
+
+		/*
+		 * The key column need not be unique, so a window may hold any number
+		 * of rows; give it up once it outgrows work_mem.  The rest of its
+		 * result is dropped when the query is executed again.
+		 */
+		if (festate->rescan_bytes > work_mem * 1024L)
+		{
+			MemoryContextReset(festate->rescan_cxt);
+			festate->rescan_rows = NULL;
+			festate->rescan_bytes = 0;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * mysql_iterate_cached
+ * 		Return the next row of the current rescan of a scan whose results are
+ * 		cached
+ *
+ * The first call of a rescan binds its parameter values, and looks the
+ * values bound up in the cache, so that they are evaluated only once even
+ * when volatile.  The rows of a result found there are replayed; otherwise
+ * the query is executed and the rows it returns are collected, and kept once
+ * all have been read.  The cache is emptied whenever it would outgrow
+ * work_mem.
+ */
+static TupleTableSlot *
+mysql_iterate_cached(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	TupleTableSlot *tupleSlot = node->ss.ss_ScanTupleSlot;
+	MySQLRescanCacheEntry *entry;
+	MemoryContext oldcontext;
+	HeapTuple	tup;
+
+	if (!festate->rescan_started)
+	{
+		MySQLRescanCacheKey key;
+
+		festate->rescan_started = true;
+		festate->rescan_list = NIL;
+		festate->rescan_next = 0;
+		festate->rescan_cache_hit = false;
+		festate->rescan_cache_fill = false;
+
+		bind_stmt_params(node);
+		mysql_rescan_cache_key(node, &key);
+
+		entry = NULL;
+		if (festate->rescan_cache)
+			entry = (MySQLRescanCacheEntry *) hash_search(festate->rescan_cache,
+														  &key, HASH_FIND,
+														  NULL);
+
+		if (entry)
+		{
+			festate->rescan_list = entry->rows;
+			festate->rescan_cache_hit = true;
+		}
+		else if (festate->rescan_cache_bytes + key.len <= work_mem * 1024L)
+		{
+			festate->rescan_cache_key = MemoryContextAlloc(festate->rescan_cache_cxt,
+														   key.len);
+			memcpy(festate->rescan_cache_key, key.data, key.len);
+			festate->rescan_cache_keylen = key.len;
+			festate->rescan_cache_bytes += key.len;
+			festate->rescan_cache_fill = true;
+		}
+
+		if (!festate->rescan_cache_hit)
+			mysql_execute_scan(festate);
+	}
+
+	if (festate->rescan_cache_hit)
+	{
+		if (festate->rescan_next >= list_length(festate->rescan_list))
+			return ExecClearTuple(tupleSlot);
+
+		tup = (HeapTuple) list_nth(festate->rescan_list,
+								   festate->rescan_next++);
+
+		/* The tuple belongs to the cache, so the slot must not free it */
+#if PG_VERSION_NUM >= 120000
+		ExecStoreHeapTuple(tup, tupleSlot, false);
+#else
+		ExecStoreTuple(tup, tupleSlot, InvalidBuffer, false);
+#endif
+		return tupleSlot;
+	}
+
+	tupleSlot = mysql_fetch_tuple(node);
+
+	if (!festate->rescan_cache_fill)
+		return tupleSlot;
+
+	/* Keep the result once it has been read entirely */
+	if (TupIsNull(tupleSlot))
+	{
+		bool		found;
+		MySQLRescanCacheKey key;
+
+		if (festate->rescan_cache == NULL)
+		{
+			HASHCTL		ctl;
+
+			MemSet(&ctl, 0, sizeof(ctl));
+			ctl.keysize = sizeof(MySQLRescanCacheKey);
+			ctl.entrysize = sizeof(MySQLRescanCacheEntry);
+			ctl.hash = mysql_rescan_cache_hash;
+			ctl.match = mysql_rescan_cache_match;
+			ctl.hcxt = festate->rescan_cache_cxt;
+			festate->rescan_cache = hash_create("mysql_fdw rescan cache", 64,
+												&ctl,
+												HASH_ELEM | HASH_FUNCTION |
+												HASH_COMPARE | HASH_CONTEXT);
+		}
+
+		key.data = festate->rescan_cache_key;
+		key.len = festate->rescan_cache_keylen;
+		entry = (MySQLRescanCacheEntry *) hash_search(festate->rescan_cache,
+													  &key, HASH_ENTER,
+													  &found);
+		entry->rows = festate->rescan_list;
+		festate->rescan_cache_bytes += sizeof(MySQLRescanCacheEntry);
+		festate->rescan_cache_fill = false;
+
+		return tupleSlot;
+	}
+
+	oldcontext = MemoryContextSwitchTo(festate->rescan_cache_cxt);
+#if PG_VERSION_NUM >= 120000
+	tup = ExecCopySlotHeapTuple(tupleSlot);
+#else
+	tup = ExecCopySlotTuple(tupleSlot);
+#endif
+	festate->rescan_list = lappend(festate->rescan_list, tup);
+	MemoryContextSwitchTo(oldcontext);
+	festate->rescan_cache_bytes += HEAPTUPLESIZE + tup->t_len +
+		sizeof(ListCell);
+
+	/*
+	 * Rather than keeping some results and not others, forget them all when
+	 * the cache outgrows work_mem, so that it fills again with the parameter
+	 * values in use from now on.
+	 */
+	if (festate->rescan_cache_bytes > work_mem * 1024L)
+	{
+		MemoryContextReset(festate->rescan_cache_cxt);
+		festate->rescan_cache = NULL;
+		festate->rescan_cache_bytes = 0;
+		festate->rescan_cache_fill = false;
+		festate->rescan_list = NIL;
+	}
+
+	return tupleSlot;
+}
+
+/*
+ * mysql_rescan_cache_key
+ * 		Build the key in the rescan cache of the parameter values bound to
+ * 		the query by bind_stmt_params()
+ *
+ * Each value is given by its output form, or a marker if it is NULL.  The
+ * key is built in the per-tuple memory.
+ */
+static void
+mysql_rescan_cache_key(ForeignScanState *node, MySQLRescanCacheKey *key)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	ExprContext *econtext = node->ss.ps.ps_ExprContext;
+	MemoryContext oldcontext;
+	StringInfoData buf;
+	int			i;
+
+	oldcontext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	initStringInfo(&buf);
+	for (i = 0; i < festate->numParams; i++)
+	{
+		const char *str = festate->param_values[i];
+
+		if (str == NULL)
+			appendStringInfoChar(&buf, 'N');
+		else
+		{
+			/* Keep the terminating zero, which separates the values */
+			appendStringInfoChar(&buf, 'V');
+			appendBinaryStringInfo(&buf, str, strlen(str) + 1);
+		}
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+
+	key->data = buf.data;
+	key->len = buf.len;
+}
+
+/*
+ * mysql_rescan_cache_drop_fill
+ * 		Forget the rows collected by a rescan cut short before it read its
+ * 		whole result
+ */
+static void
+mysql_rescan_cache_drop_fill(MySQLFdwExecState * festate)
+{
+	ListCell   *lc;
+
+	foreach(lc, festate->rescan_list)
+	{
+		HeapTuple	tup = (HeapTuple) lfirst(lc);
+
+		festate->rescan_cache_bytes -= HEAPTUPLESIZE + tup->t_len +
+			sizeof(ListCell);
+	}
+	festate->rescan_cache_bytes -= festate->rescan_cache_keylen;
+
+	list_free_deep(festate->rescan_list);
+	pfree(festate->rescan_cache_key);
+	festate->rescan_list = NIL;
+	festate->rescan_cache_key = NULL;
+	festate->rescan_cache_fill = false;
+}
+
+/*
+ * Hash function for the keys of the rescan cache.
+ */
+static uint32
+mysql_rescan_cache_hash(const void *key, Size keysize)
+{
+	const MySQLRescanCacheKey *k = (const MySQLRescanCacheKey *) key;
+
+	return DatumGetUInt32(hash_any((const unsigned char *) k->data, k->len));
+}
+
+/*
+ * Comparison function for the keys of the rescan cache.  Like memcmp(), it
+ * returns zero when the keys are equal.
+ */
+static int
+mysql_rescan_cache_match(const void *key1, const void *key2, Size keysize)
+{
+	const MySQLRescanCacheKey *k1 = (const MySQLRescanCacheKey *) key1;
+	const MySQLRescanCacheKey *k2 = (const MySQLRescanCacheKey *) key2;
+
+	if (k1->len != k2->len)
+		return 1;
+
+	return memcmp(k1->data, k2->data, k1->len);
+}
+
+/*
+ * mysqlExplainForeignScan
+ * 		Produce extra output for EXPLAIN
+ */
+static void
+mysqlExplainForeignScan(ForeignScanState *node, ExplainState *es)
+{
+	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
+	int			rtindex;
+	RangeTblEntry *rte;
+	EState	   *estate = node->ss.ps.state;
+	List	   *fdw_private = fsplan->fdw_private;
+	List	   *rescan_batch;
+
+	if (fsplan->scan.scanrelid > 0)
+		rtindex = fsplan->scan.scanrelid;
+	else
+		rtindex = bms_next_member(fsplan->fs_relids, -1);
+	rte = exec_rt_fetch(rtindex, estate);
+
+	if (list_length(fdw_private) > mysqlFdwScanPrivateRelations)
+	{
+		char	   *relations = strVal(list_nth(fdw_private,
+												mysqlFdwScanPrivateRelations));
+
+		ExplainPropertyText("Relations", relations, es);
+	}
+
+	/* Give some possibly useful info about startup costs */
+	if (es->costs)
+	{
+		mysql_opt  *options = mysql_get_options(rte->relid, true);
+		int			startup_cost = mysql_startup_cost(options);
+
+		if (startup_cost < MYSQL_REMOTE_STARTUP_COST)
+#if PG_VERSION_NUM >= 110000
+			ExplainPropertyInteger("Local server startup cost", NULL,
+								   startup_cost, es);
+#else
+			ExplainPropertyLong("Local server startup cost", startup_cost, es);
+#endif
+		else
+#if PG_VERSION_NUM >= 110000
+			ExplainPropertyInteger("Remote server startup cost", NULL,
+								   startup_cost, es);
+#else
+			ExplainPropertyLong("Remote server startup cost", startup_cost,
+								es);
+#endif
+	}
+	/* Show the remote query in verbose mode */
+	if (es->verbose)
+	{
+		char	   *remote_sql = strVal(list_nth(fdw_private,
+												 mysqlFdwScanPrivateSelectSql));
+
+		mysql_opt  *options = mysql_get_options(rte->relid, true);
+
+		ExplainPropertyText("Remote query", remote_sql, es);
+
+		/* Mention the scan mode only when it is not the default one */
+		if (options->scan_mode == MYSQL_SCAN_MODE_STREAM)
+			ExplainPropertyText("Scan mode", "stream", es);
+		else if (options->scan_mode == MYSQL_SCAN_MODE_BUFFERED)
+			ExplainPropertyText("Scan mode", "buffered", es);
+
+		/* Show how many keys a batched parameterized scan reads at once */
+		rescan_batch = list_nth(fdw_private, mysqlFdwScanPrivateRescanBatch);
+		if (rescan_batch != NIL)
+#if PG_VERSION_NUM >= 110000
+			ExplainPropertyInteger("Rescan batch size", NULL,
+								   linitial_int(rescan_batch), es);
+#else
+			ExplainPropertyLong("Rescan batch size",
+								linitial_int(rescan_batch), es);
+#endif
+	}
+
+	/* Show the remote work of the scan under ANALYZE */
+	if (node->fdw_state != NULL)
+	{
+		MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+		MySQLInstrumentation *instr = festate->instr;
+
+		/*
+		 * The server counts the bytes it sends once compressed.  This cannot
+		 * be asked while a stream scan still has rows to read, and counts
+		 * those of other scans sharing the connection as well.
+		 */
+		if (instr && instr->compressed && instr->bytes_sent_start >= 0 &&
+			!festate->rows_pending && festate->conn != NULL)
+		{
+			int64		bytes_sent = mysql_get_bytes_sent(festate->conn);
+
+			if (bytes_sent >= 0)
+				instr->bytes_received = bytes_sent - instr->bytes_sent_start;
+		}
+
+		mysql_explain_instr(instr, true, es);
+	}
+}
+
+/*
+ * mysqlEndForeignScan
+ * 		Finish scanning foreign table and dispose objects used for this scan
+ */
+static void
+mysqlEndForeignScan(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+
+	/* if festate is NULL, we are in EXPLAIN; do nothing */
+	if (festate == NULL)
+		return;
+
+#ifdef MYSQL_FDW_ASYNC
+	mysql_discard_async_execute(node);
+#endif
+
+	/* Count a query whose result was not read entirely */
+	mysql_scan_stat_end(festate);
+
+	if (festate->table && festate->table->mysql_res)
+	{
+		mysql_free_result(festate->table->mysql_res);
+		festate->table->mysql_res = NULL;
+	}
+
+	if (festate->scan_mode == MYSQL_SCAN_MODE_STREAM)
+		mysql_close_stream_connection(festate);
+
+	if (festate->stmt)
+	{
+		mysql_stmt_cache_release(festate->conn, festate->stmt,
+								 festate->cursor_open);
+		festate->stmt = NULL;
+	}
+}
+
+/*
+ * mysql_close_stream_connection
+ * 		Give back the private connection of a stream scan, and close its
+ * 		statement
+ *
+ * A connection with rows not read yet is closed rather than given back to
+ * the pool, which drops the rows instead of having mysql_stmt_close() read
+ * and discard them.  This is also used as a memory context reset callback,
+ * so it must not throw an error.
+ */
+static void
+mysql_close_stream_connection(void *arg)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) arg;
+
+	if (festate->conn == NULL)
+		return;
+
+	if (festate->rows_pending)
+		mysql_release_private_connection(festate->conn, true);
+
+	if (festate->stmt)
+	{
+		mysql_stmt_close(festate->stmt);
+		festate->stmt = NULL;
+	}
+
+	if (!festate->rows_pending)
+		mysql_release_private_connection(festate->conn, false);
+	festate->conn = NULL;
+}
+
+/*
+ * mysqlIsForeignScanParallelSafe
+ * 		Check whether a scan of the foreign table can be run in a parallel
+ * 		worker
+ *
+ * A worker uses a connection, and so a remote transaction, of its own.  This
+ * is only allowed for tables whose parallel_workers option is set.
+ */
+static bool
+mysqlIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
+							   RangeTblEntry *rte)
+{
+	mysql_opt  *options = mysql_get_options(rte->relid, true);
+
+	return options->parallel_workers > 0;
+}
+
+/*
+ * mysqlEstimateDSMForeignScan
+ * 		Estimate the size of the state shared by a parallel scan
+ */
+static Size
+mysqlEstimateDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt)
+{
+	return sizeof(MySQLParallelScanState);
+}
+
+/*
+ * mysqlInitializeDSMForeignScan
+ * 		Look up the range of keys of the foreign table and split it in the
+ * 		ranges the processes of a parallel scan will read
+ */
+static void
+mysqlInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+							  void *coordinate)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLParallelScanState *pscan = (MySQLParallelScanState *) coordinate;
+	StringInfoData sql;
+	MYSQL_RES  *result;
+	MYSQL_ROW	row;
+	uint64		nranges;
+
+	/* Nothing to do in EXPLAIN (no ANALYZE) case */
+	if (festate == NULL)
+		return;
+
+	initStringInfo(&sql);
+	mysql_deparse_key_range(&sql, node->ss.ss_currentRelation);
+
+	if (mysql_run_query(festate->conn, sql.data) != 0)
+		mysql_error_print(festate->conn);
+
+	result = mysql_store_result(festate->conn);
+	if (result == NULL)
+		mysql_error_print(festate->conn);
+
+	row = mysql_fetch_row(result);
+	if (row && row[0] && row[1])
+	{
+		pscan->lo = (int64) strtoll(row[0], NULL, 10);
+		pscan->hi = (int64) strtoll(row[1], NULL, 10);
+	}
+	else
+	{
+		/* No key at all, so only rows with a NULL key are to be read */
+		pscan->lo = 0;
+		pscan->hi = -1;
+	}
+	mysql_free_result(result);
+
+	/*
+	 * The width of the key range may exceed INT64_MAX, hence the unsigned
+	 * arithmetic.
+	 */
+	nranges = (uint64) (pcxt->nworkers + 1) * MYSQL_PARALLEL_RANGES_PER_PROCESS;
+	if (pscan->hi >= pscan->lo)
+	{
+		uint64		span = (uint64) pscan->hi - (uint64) pscan->lo;
+
+		pscan->width = span / nranges + 1;
+		pscan->nranges = span / pscan->width + 1;
+	}
+	else
+	{
+		pscan->width = 0;
+		pscan->nranges = 1;
+	}
+	pg_atomic_init_u64(&pscan->next_range, 0);
+
+	festate->pscan = pscan;
+}
+
+#if PG_VERSION_NUM >= 100000
+/*
+ * mysqlReInitializeDSMForeignScan
+ * 		Reset the shared state of a parallel scan before a rescan
+ */
+static void
+mysqlReInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+								void *coordinate)
+{
+	MySQLParallelScanState *pscan = (MySQLParallelScanState *) coordinate;
+
+	pg_atomic_write_u64(&pscan->next_range, 0);
+}
+#endif
+
+/*
+ * mysqlInitializeWorkerForeignScan
+ * 		Attach a parallel worker to the shared state of a parallel scan
+ */
+static void
+mysqlInitializeWorkerForeignScan(ForeignScanState *node, shm_toc *toc,
+								 void *coordinate)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+
+	if (festate == NULL)
+		return;
+
+	festate->pscan = (MySQLParallelScanState *) coordinate;
+}
+
+/*
+ * mysql_next_parallel_range
+ * 		Get the next range of keys for a parallel scan to read
+ *
+ * Returns false once all ranges have been taken.
+ */
+static bool
+mysql_next_parallel_range(MySQLFdwExecState * festate)
+{
+	MySQLParallelScanState *pscan = festate->pscan;
+	uint64		range;
+
+	/* Without a parallel context, a single range covers all the keys */
+	if (pscan == NULL)
+	{
+		if (festate->range_done)
+			return false;
+
+		festate->range_lo = PG_INT64_MIN;
+		festate->range_hi = PG_INT64_MAX;
+		festate->range_nulls = 1;
+		festate->range_done = true;
+		return true;
+	}
+
+	range = pg_atomic_fetch_add_u64(&pscan->next_range, 1);
+	if (range >= pscan->nranges)
+		return false;
+
+	festate->range_lo = (int64) ((uint64) pscan->lo + range * pscan->width);
+	if (range == pscan->nranges - 1)
+		festate->range_hi = pscan->hi;
+	else
+		festate->range_hi = (int64) ((uint64) festate->range_lo + pscan->width - 1);
+
+	/* Rows with a NULL key are read along with the first range */
+	festate->range_nulls = (range == 0);
+
+	return true;
+}
+
+/*
+ * mysql_parallel_divisor
+ * 		Estimate the share of the rows of a parallel scan read by each
+ * 		process, like the core code does for parallel sequential scans
+ */
+static double
+mysql_parallel_divisor(int parallel_workers)
+{
+	double		parallel_divisor = parallel_workers;
+
+#if PG_VERSION_NUM >= 110000
+	if (parallel_leader_participation)
+#endif
+	{
+		double		leader_contribution;
+
+		leader_contribution = 1.0 - (0.3 * parallel_workers);
+		if (leader_contribution > 0)
+			parallel_divisor += leader_contribution;
+	}
+
+	return parallel_divisor;
+}
+
+/*
+ * mysql_rescan_batch_clause
+ *		Find among the given join clauses of a base relation one that a
+ *		batched parameterized scan can check on a window of keys
+ *
+ * Such a clause compares an integer column of the relation for equality with
+ * an integer expression of other relations.  That column and expression are
+ * returned in *key_var and *outer_expr, unless those are NULL.
+ *
+ * Windows only pay off when the outer rows come in key order, and when each
+ * key has few rows.  The ordering of the outer rows is not known when the
+ * scan is costed, so an index of the outer relation led by the outer column
+ * is taken as the sign of it.  The key column has to be unique on the MySQL
+ * server.
+ */
+static RestrictInfo *
+mysql_rescan_batch_clause(PlannerInfo *root, RelOptInfo *baserel,
+						  List *clauses, Var **key_var, Expr **outer_expr)
+{
+	ListCell   *lc;
+
+	foreach(lc, clauses)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+		OpExpr	   *op;
+		Node	   *left;
+		Node	   *right;
+		Node	   *key;
+		Node	   *other;
+		Var		   *var;
+
+		if (!IsA(rinfo->clause, OpExpr))
+			continue;
+
+		op = (OpExpr *) rinfo->clause;
+		if (list_length(op->args) != 2)
+			continue;
+
+		left = linitial(op->args);
+		right = lsecond(op->args);
+
+		/* The operator has to be an equality between integers */
+		if (!mysql_is_integer_type(exprType(left)) ||
+			!mysql_is_integer_type(exprType(right)) ||
+			!op_mergejoinable(op->opno, exprType(left)))
+			continue;
+
+		/* One side has to be the column, the other one the parameter */
+		if (bms_is_member(baserel->relid, rinfo->left_relids) &&
+			!bms_is_member(baserel->relid, rinfo->right_relids))
+		{
+			key = left;
+			other = right;
+		}
+		else if (bms_is_member(baserel->relid, rinfo->right_relids) &&
+				 !bms_is_member(baserel->relid, rinfo->left_relids))
+		{
+			key = right;
+			other = left;
+		}
+		else
+			continue;
+
+		if (!IsA(key, Var))
+			continue;
+
+		var = (Var *) key;
+		if (var->varno != baserel->relid || var->varlevelsup != 0 ||
+			var->varattno <= 0)
+			continue;
+
+		if (!mysql_is_foreign_expr(root, baserel, rinfo->clause))
+			continue;
+
+		if (!mysql_outer_key_is_ordered(root, (Expr *) other) ||
+			!mysql_rescan_key_is_unique(root, baserel, var->varattno))
+			continue;
+
+		if (key_var)
+			*key_var = var;
+		if (outer_expr)
+			*outer_expr = (Expr *) other;
+
+		return rinfo;
+	}
+
+	return NULL;
+}
+
+/*
+ * mysql_outer_key_is_ordered
+ *		Check whether the outer expression of a batched parameterized scan is
+ *		a column of a base relation having a btree index led by that column,
+ *		from which the outer rows can come in key order
+ */
+static bool
+mysql_outer_key_is_ordered(PlannerInfo *root, Expr *outer_expr)
+{
+	Var		   *var;
+	RelOptInfo *rel;
+	ListCell   *lc;
+
+	while (IsA(outer_expr, RelabelType))
+		outer_expr = ((RelabelType *) outer_expr)->arg;
+
+	if (!IsA(outer_expr, Var))
+		return false;
+
+	var = (Var *) outer_expr;
+	if (var->varlevelsup != 0 || var->varattno <= 0 ||
+		var->varno >= root->simple_rel_array_size)
+		return false;
+
+	rel = root->simple_rel_array[var->varno];
+	if (rel == NULL || rel->reloptkind != RELOPT_BASEREL)
+		return false;
+
+	foreach(lc, rel->indexlist)
+	{
+		IndexOptInfo *index = (IndexOptInfo *) lfirst(lc);
+
+		if (index->sortopfamily != NULL && index->indexkeys[0] == var->varattno)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * mysql_rescan_key_is_unique
+ *		Check whether a column of a foreign table is unique on the MySQL
+ *		server, that is, the only column of a unique index of its table
+ *
+ * The server is asked once per column while planning a query, and only in
+ * use_remote_estimate mode, which parameterized scans need.
+ */
+static bool
+mysql_rescan_key_is_unique(PlannerInfo *root, RelOptInfo *baserel,
+						   AttrNumber attno)
+{
+	MySQLFdwRelationInfo *fpinfo = (MySQLFdwRelationInfo *) baserel->fdw_private;
+	RangeTblEntry *rte = planner_rt_fetch(baserel->relid, root);
+	mysql_opt  *options;
+	MYSQL	   *conn;
+	MYSQL_RES  *result;
+	StringInfoData sql;
+	bool		unique = false;
+
+	if (fpinfo->user == NULL)
+		return false;
+
+	if (bms_is_member(attno, fpinfo->unique_keys_checked))
+		return bms_is_member(attno, fpinfo->unique_keys);
+
+	options = mysql_get_options(rte->relid, true);
+	conn = mysql_get_connection(fpinfo->server, fpinfo->user, options,
+								mysql_query_is_read_only(root));
+
+	initStringInfo(&sql);
+	appendStringInfo(&sql,
+					 "SELECT 1 FROM information_schema.STATISTICS"
+					 " WHERE TABLE_SCHEMA = %s AND TABLE_NAME = %s"
+					 " AND NON_UNIQUE = 0"
+					 " GROUP BY INDEX_NAME"
+					 " HAVING COUNT(*) = 1 AND MAX(COLUMN_NAME) = %s",
+					 mysql_quote_identifier(options->svr_database, '\''),
+					 mysql_quote_identifier(options->svr_table, '\''),
+					 mysql_quote_identifier(mysql_get_column_name(rte->relid,
+																  attno),
+											'\''));
+
+	if (mysql_run_query(conn, sql.data) != 0)
+		mysql_error_print(conn);
+
+	result = mysql_store_result(conn);
+	if (result)
+	{
+		unique = mysql_num_rows(result) > 0;
+		mysql_free_result(result);
+	}
+
+	fpinfo->unique_keys_checked = bms_add_member(fpinfo->unique_keys_checked,
+												 attno);
+	if (unique)
+		fpinfo->unique_keys = bms_add_member(fpinfo->unique_keys, attno);
+
+	return unique;
+}
+
+/*
+ * mysql_is_integer_type
+ *		Check whether a type is one of the integer types whose values a
+ *		batched parameterized scan can compare as int64
+ */
+static bool
+mysql_is_integer_type(Oid type)
+{
+	return type == INT2OID || type == INT4OID || type == INT8OID;
+}
+
+/*
+ * mysql_integer_datum
+ *		Get the value of a datum of an integer type as int64
+ */
+static int64
+mysql_integer_datum(Datum value, Oid type)
+{
+	switch (type)
+	{
+		case INT2OID:
+			return (int64) DatumGetInt16(value);
+		case INT4OID:
+			return (int64) DatumGetInt32(value);
+		default:
+			return DatumGetInt64(value);
+	}
+}
+
+#ifdef MYSQL_FDW_ASYNC
+/*
+ * mysqlIsForeignPathAsyncCapable
+ * 		Check whether a given ForeignPath node is async-capable
+ */
+static bool
+mysqlIsForeignPathAsyncCapable(ForeignPath *path)
+{
+	RelOptInfo *rel = ((Path *) path)->parent;
+	MySQLFdwRelationInfo *fpinfo = (MySQLFdwRelationInfo *) rel->fdw_private;
+
+	/* A parallel scan executes its query once for each range of keys */
+	if (((Path *) path)->parallel_aware)
+		return false;
+
+	/* A batched parameterized scan answers most rescans without a query */
+	if (((Path *) path)->param_info && fpinfo->rescan_batch_size > 1)
+		return false;
+
+	/*
+	 * Neither does a cached one, which binds its params before it knows
+	 * whether the query is to be executed at all.
+	 */
+	if (((Path *) path)->param_info && fpinfo->rescan_cache)
+		return false;
+
+	return fpinfo->async_capable && mysql_async_supported;
+}
+
+/*
+ * mysqlForeignAsyncRequest
+ * 		Asynchronously request next tuple from a foreign MySQL table
+ *
+ * Only the execution of the query, during which the remote server computes
+ * the result, is done asynchronously.  Rows are then fetched synchronously,
+ * like for any other scan.
+ */
+static void
+mysqlForeignAsyncRequest(AsyncRequest *areq)
+{
+	ForeignScanState *node = (ForeignScanState *) areq->requestee;
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLConnState *state = festate->conn_state;
+
+	if (festate->query_executed)
+	{
+		ExecAsyncRequestDone(areq, mysqlIterateForeignScan(node));
+		return;
+	}
+
+	/*
+	 * A connection runs one query at a time, so the one executing for
+	 * another scan sharing the connection has to finish first.
+	 */
+	if (state->pending_areq)
+		mysql_process_pending_request(state->pending_areq);
+
+	mysql_begin_async_execute(areq);
+}
+
+/*
+ * mysqlForeignAsyncConfigureWait
+ * 		Configure a file descriptor event for which we wish to wait
+ */
+static void
+mysqlForeignAsyncConfigureWait(AsyncRequest *areq)
+{
+	ForeignScanState *node = (ForeignScanState *) areq->requestee;
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLConnState *state = festate->conn_state;
+	AppendState *requestor = (AppendState *) areq->requestor;
+	uint32		events;
+	long		timeout;
 
-	foreach(lc, festate->retrieved_attrs)
-	{
-		int			attnum = lfirst_int(lc) - 1;
-		Oid			pgtype = TupleDescAttr(tupleDescriptor, attnum)->atttypid;
-		int32		pgtypmod = TupleDescAttr(tupleDescriptor, attnum)->atttypmod;
+	/* This should not be called unless callback_pending */
+	Assert(areq->callback_pending);
+	Assert(state->pending_areq == areq);
 
-		if (TupleDescAttr(tupleDescriptor, attnum)->attisdropped)
-			continue;
+	/*
+	 * The event set of the Append waits with no timeout, so a read timeout
+	 * of the client library only applies once the query is waited for by
+	 * mysql_finish_async_execute.
+	 */
+	events = mysql_async_wait_events(state->conn, state->pending_status,
+									 &timeout) & ~WL_TIMEOUT;
 
-		festate->table->column[atindex].mysql_bind = &festate->table->mysql_bind[atindex];
+	AddWaitEventToSet(requestor->as_eventset, events,
+					  mysql_get_socket(state->conn), NULL, areq);
+}
 
-		mysql_bind_result(pgtype, pgtypmod,
-						  &festate->table->mysql_fields[atindex],
-						  &festate->table->column[atindex]);
-		atindex++;
+/*
+ * mysqlForeignAsyncNotify
+ * 		Continue the execution of the query now that the connection is ready,
+ * 		and produce a tuple once it has finished
+ */
+static void
+mysqlForeignAsyncNotify(AsyncRequest *areq)
+{
+	ForeignScanState *node = (ForeignScanState *) areq->requestee;
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLConnState *state = festate->conn_state;
+	uint32		events;
+	long		timeout;
+	int			rc;
+	int			ready;
+
+	/* The core code would have initialized the callback_pending flag */
+	Assert(!areq->callback_pending);
+	Assert(state->pending_areq == areq);
+
+	/*
+	 * We are not told which of the events waited for occurred, so poll the
+	 * socket for them without blocking, and go on waiting if none did.
+	 */
+	events = mysql_async_wait_events(state->conn, state->pending_status,
+									 &timeout) & ~WL_TIMEOUT;
+	rc = WaitLatchOrSocket(NULL, events | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						   mysql_get_socket(state->conn), 0,
+						   mysql_wait_event(MYSQL_WAIT_EVENT_EXECUTE));
+	ready = mysql_async_ready_status(state->pending_status, rc & ~WL_TIMEOUT);
+
+	if (ready != 0)
+		state->pending_status =
+			mysql_stmt_execute_cont(&state->pending_ret, state->pending_stmt,
+									ready);
+
+	/* Wait for the connection again if the query is still executing */
+	if (state->pending_status != 0)
+	{
+		ExecAsyncRequestPending(areq);
+		return;
 	}
 
-	/* Bind the results pointers for the prepare statements */
-	if (mysql_stmt_bind_result(festate->stmt, festate->table->mysql_bind) != 0)
-		mysql_stmt_error_print(festate->conn, festate->stmt, "failed to bind the MySQL query");
+	mysql_end_async_execute(node);
+	ExecAsyncRequestDone(areq, mysqlIterateForeignScan(node));
 }
 
 /*
- * mysqlIterateForeignScan
- * 		Iterate and get the rows one by one from  MySQL and placed in tuple
- * 		slot
+ * mysql_begin_async_execute
+ * 		Bind the query params of a scan and start executing its query
+ * 		without waiting for the result
  */
-static TupleTableSlot *
-mysqlIterateForeignScan(ForeignScanState *node)
+static void
+mysql_begin_async_execute(AsyncRequest *areq)
 {
+	ForeignScanState *node = (ForeignScanState *) areq->requestee;
 	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
-	TupleTableSlot *tupleSlot = node->ss.ss_ScanTupleSlot;
-	int			attid;
-	ListCell   *lc;
-	int			rc = 0;
-	Datum	   *dvalues;
-	bool	   *nulls;
-	int			natts;
-	AttInMetadata *attinmeta = festate->attinmeta;
-	HeapTuple	tup;
-	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
-	List	   *fdw_private = fsplan->fdw_private;
+	MySQLConnState *state = festate->conn_state;
 
-	natts = attinmeta->tupdesc->natts;
+	Assert(state->pending_areq == NULL);
 
-	dvalues = palloc0(natts * sizeof(Datum));
-	nulls = palloc(natts * sizeof(bool));
-	/* Initialize to nulls for any columns not present in result */
-	memset(nulls, true, natts * sizeof(bool));
+	bind_stmt_params(node);
 
-	ExecClearTuple(tupleSlot);
+	mysql_scan_stat_start(festate);
 
-	/*
-	 * If this is the first call after Begin or ReScan, we need to bind the
-	 * params and execute the query.
-	 */
-	if (!festate->query_executed)
-		bind_stmt_params_and_exec(node);
+	if (festate->instr)
+	{
+		festate->instr->executes++;
+		festate->instr->round_trips++;
+		festate->instr->result_rows = 0;
+		if (festate->instr->need_timer)
+			INSTR_TIME_SET_CURRENT(festate->instr->execute_start);
+	}
 
-	attid = 0;
-	rc = mysql_stmt_fetch(festate->stmt);
+	state->pending_areq = areq;
+	state->pending_stmt = festate->stmt;
+	state->pending_status = mysql_stmt_execute_start(&state->pending_ret,
+													 festate->stmt);
 
-	if (rc == 0)
+	/* The query may well have finished without having to wait */
+	if (state->pending_status == 0)
 	{
-		foreach(lc, festate->retrieved_attrs)
-		{
-			int			attnum = lfirst_int(lc) - 1;
-			Oid			pgtype = TupleDescAttr(attinmeta->tupdesc, attnum)->atttypid;
-			int32		pgtypmod = TupleDescAttr(attinmeta->tupdesc, attnum)->atttypmod;
+		mysql_end_async_execute(node);
+		ExecAsyncRequestDone(areq, mysqlIterateForeignScan(node));
+		return;
+	}
 
-			nulls[attnum] = festate->table->column[attid].is_null;
-			if (!festate->table->column[attid].is_null)
-				dvalues[attnum] = mysql_convert_to_pg(pgtype,
-													  pgtypmod,
-													  &festate->table->column[attid],
-													  festate->table->mysql_fields[attid]);
+	ExecAsyncRequestPending(areq);
+}
 
-			attid++;
-		}
+/*
+ * mysql_finish_async_execute
+ * 		Wait until the query executing asynchronously on the connection has
+ * 		finished
+ *
+ * With interruptible, interrupts are serviced while waiting, so that a query
+ * cancel gets through; the query is then left executing for the abort of
+ * the transaction to finish.  That uses this without interruptible, as it
+ * must not throw an error.  The outcome of the execution is left in
+ * state->pending_ret.
+ */
+void
+mysql_finish_async_execute(MySQLConnState *state, bool interruptible)
+{
+	while (state->pending_status != 0)
+	{
+		uint32		events;
+		long		timeout;
+		int			rc;
 
-		ExecClearTuple(tupleSlot);
+		events = mysql_async_wait_events(state->conn, state->pending_status,
+										 &timeout);
+		if (interruptible)
+			events |= WL_LATCH_SET;
 
-		if (list_length(fdw_private) >= mysqlFdwPrivateScanTList)
-		{
-			/* Construct tuple with whole-row references. */
-			tup = mysql_get_tuple_with_whole_row(festate, dvalues, nulls);
-		}
-		else
+		rc = WaitLatchOrSocket(interruptible ? MyLatch : NULL,
+							   events | WL_EXIT_ON_PM_DEATH,
+							   mysql_get_socket(state->conn), timeout,
+							   mysql_wait_event(MYSQL_WAIT_EVENT_EXECUTE));
+
+		if (rc & WL_LATCH_SET)
 		{
-			/* Form the Tuple using Datums */
-			tup = heap_form_tuple(attinmeta->tupdesc, dvalues, nulls);
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+
+			/* Only the latch was set, wait for the connection again */
+			if (mysql_async_ready_status(state->pending_status, rc) == 0)
+				continue;
 		}
 
-		if (tup)
-#if PG_VERSION_NUM >= 120000
-			ExecStoreHeapTuple(tup, tupleSlot, false);
-#else
-			ExecStoreTuple(tup, tupleSlot, InvalidBuffer, false);
-#endif
-		else
-			mysql_stmt_close(festate->stmt);
+		state->pending_status =
+			mysql_stmt_execute_cont(&state->pending_ret, state->pending_stmt,
+									mysql_async_ready_status(state->pending_status,
+															 rc));
+	}
+}
 
-		/*
-		 * Release locally palloc'd space dvalues and nulls is process by
-		 * memory context
-		 */
+/*
+ * mysql_async_wait_events
+ * 		Translate the status returned by a call of the non-blocking client
+ * 		API into the events to wait for, and the timeout in milliseconds, or
+ * 		-1 when there is none
+ *
+ * An exceptional condition on the socket is waited for as the socket being
+ * readable, which is how the latch code reports errors and hang-ups.
+ */
+uint32
+mysql_async_wait_events(MYSQL * conn, int status, long *timeout)
+{
+	uint32		events = 0;
 
-	}
-	else if (rc == 1)
-	{
-		/*
-		 * Error occurred. Error code and message can be obtained by calling
-		 * mysql_stmt_errno() and mysql_stmt_error().
-		 */
-	}
-	else if (rc == MYSQL_NO_DATA)
-	{
-		/*
-		 * No more rows/data exists
-		 */
-	}
-	else if (rc == MYSQL_DATA_TRUNCATED)
+	if (status & (MYSQL_WAIT_READ | MYSQL_WAIT_EXCEPT))
+		events |= WL_SOCKET_READABLE;
+	if (status & MYSQL_WAIT_WRITE)
+		events |= WL_SOCKET_WRITEABLE;
+
+	*timeout = -1L;
+	if (status & MYSQL_WAIT_TIMEOUT)
 	{
-		/* Data truncation occurred */
-		/*
-		 * MYSQL_DATA_TRUNCATED is returned when truncation reporting is
-		 * enabled. To determine which column values were truncated when this
-		 * value is returned, check the error members of the MYSQL_BIND
-		 * structures used for fetching values. Truncation reporting is
-		 * enabled by default, but can be controlled by calling
-		 * mysql_options() with the MYSQL_REPORT_DATA_TRUNCATION option.
-		 */
+		events |= WL_TIMEOUT;
+		*timeout = (long) mysql_get_timeout_value_ms(conn);
 	}
 
-	return tupleSlot;
+	return events;
 }
 
+/*
+ * mysql_async_ready_status
+ * 		Translate the events that occurred while waiting for the status
+ * 		returned by a call of the non-blocking client API into the status to
+ * 		pass to the next call
+ */
+int
+mysql_async_ready_status(int status, int occurred)
+{
+	int			ready = 0;
+
+	if (occurred & WL_SOCKET_READABLE)
+		ready |= status & (MYSQL_WAIT_READ | MYSQL_WAIT_EXCEPT);
+	if (occurred & WL_SOCKET_WRITEABLE)
+		ready |= MYSQL_WAIT_WRITE;
+	if (occurred & WL_TIMEOUT)
+		ready |= MYSQL_WAIT_TIMEOUT;
+
+	return ready;
+}
 
 /*
- * mysqlExplainForeignScan
- * 		Produce extra output for EXPLAIN
+ * mysql_end_async_execute
+ * 		Take the outcome of a scan's query that has finished executing
+ * 		asynchronously, and release the connection for other scans
  */
 static void
-mysqlExplainForeignScan(ForeignScanState *node, ExplainState *es)
+mysql_end_async_execute(ForeignScanState *node)
 {
-	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
-	int			rtindex;
-	RangeTblEntry *rte;
-	EState	   *estate = node->ss.ps.state;
-	List	   *fdw_private = fsplan->fdw_private;
-
-	if (fsplan->scan.scanrelid > 0)
-		rtindex = fsplan->scan.scanrelid;
-	else
-		rtindex = bms_next_member(fsplan->fs_relids, -1);
-	rte = exec_rt_fetch(rtindex, estate);
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLConnState *state = festate->conn_state;
 
-	if (list_length(fdw_private) > mysqlFdwScanPrivateRelations)
-	{
-		char	   *relations = strVal(list_nth(fdw_private,
-												mysqlFdwScanPrivateRelations));
+	Assert(state->pending_status == 0);
 
-		ExplainPropertyText("Relations", relations, es);
-	}
+	state->pending_areq = NULL;
+	state->pending_stmt = NULL;
 
-	/* Give some possibly useful info about startup costs */
-	if (es->costs)
-	{
-		mysql_opt  *options = mysql_get_options(rte->relid, true);
+	if (festate->instr && festate->instr->need_timer)
+		mysql_instr_accum(festate->instr, &festate->instr->execute_time,
+						  festate->instr->execute_start);
 
-		if (strcmp(options->svr_address, "127.0.0.1") == 0 ||
-			strcmp(options->svr_address, "localhost") == 0)
-#if PG_VERSION_NUM >= 110000
-			ExplainPropertyInteger("Local server startup cost", NULL, 10, es);
-#else
-			ExplainPropertyLong("Local server startup cost", 10, es);
-#endif
-		else
-#if PG_VERSION_NUM >= 110000
-			ExplainPropertyInteger("Remote server startup cost", NULL, 25, es);
-#else
-			ExplainPropertyLong("Remote server startup cost", 25, es);
-#endif
-	}
-	/* Show the remote query in verbose mode */
-	if (es->verbose)
-	{
-		char	   *remote_sql = strVal(list_nth(fdw_private,
-												 mysqlFdwScanPrivateSelectSql));
+	if (state->pending_ret != 0)
+		mysql_stmt_error_print(festate->conn, festate->stmt, "failed to execute the MySQL query");
 
-		ExplainPropertyText("Remote query", remote_sql, es);
-	}
+	mysql_scan_executed(festate);
 }
 
 /*
- * mysqlEndForeignScan
- * 		Finish scanning foreign table and dispose objects used for this scan
+ * mysql_discard_async_execute
+ * 		Throw away the result of a scan's query if it is still executing
+ * 		asynchronously, for a rescan or the end of the scan
  */
 static void
-mysqlEndForeignScan(ForeignScanState *node)
+mysql_discard_async_execute(ForeignScanState *node)
 {
 	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+	MySQLConnState *state = festate->conn_state;
 
-	/* if festate is NULL, we are in EXPLAIN; do nothing */
-	if (festate == NULL)
+	if (state == NULL || state->pending_areq == NULL ||
+		state->pending_areq->requestee != (PlanState *) node)
 		return;
 
-	if (festate->table && festate->table->mysql_res)
-	{
-		mysql_free_result(festate->table->mysql_res);
-		festate->table->mysql_res = NULL;
-	}
+	mysql_finish_async_execute(state, true);
+	mysql_stmt_reset(state->pending_stmt);
 
-	if (festate->stmt)
-	{
-		mysql_stmt_close(festate->stmt);
-		festate->stmt = NULL;
-	}
+	state->pending_areq = NULL;
+	state->pending_stmt = NULL;
+}
+
+/*
+ * mysql_process_pending_request
+ * 		Finish the query executing asynchronously for a scan, and hand its
+ * 		first tuple over to the requestor
+ *
+ * This is used when the connection is needed for something else while the
+ * query executes.
+ */
+static void
+mysql_process_pending_request(AsyncRequest *areq)
+{
+	ForeignScanState *node = (ForeignScanState *) areq->requestee;
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+
+	/* The request would have been pending for a callback */
+	Assert(areq->callback_pending);
+
+	/* Unlike AsyncNotify, we unset callback_pending ourselves */
+	areq->callback_pending = false;
+
+	mysql_finish_async_execute(festate->conn_state, true);
+	mysql_end_async_execute(node);
+	ExecAsyncRequestDone(areq, mysqlIterateForeignScan(node));
+
+	/* Unlike AsyncNotify, we call ExecAsyncResponse ourselves */
+	ExecAsyncResponse(areq);
+}
+
+/*
+ * mysql_complete_pending_request
+ * 		Finish the query executing asynchronously on a connection, if any, so
+ * 		that the connection can be used to modify a foreign table
+ */
+static void
+mysql_complete_pending_request(MYSQL * conn)
+{
+	MySQLConnState *state = mysql_get_conn_state(conn);
+
+	if (state && state->pending_areq)
+		mysql_process_pending_request(state->pending_areq);
 }
+#endif
 
 /*
  * mysqlReScanForeignScan
@@ -1125,12 +2991,30 @@ mysqlReScanForeignScan(ForeignScanState *node)
 {
 	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
 
+#ifdef MYSQL_FDW_ASYNC
+	mysql_discard_async_execute(node);
+#endif
+
 	/*
 	 * Set the query_executed flag to false so that the query will be executed
 	 * in mysqlIterateForeignScan().
 	 */
 	festate->query_executed = false;
+	festate->range_done = false;
 
+	/* Rows fetched ahead belong to the previous execution */
+	festate->fetched_rows = 0;
+	festate->fetch_next = 0;
+
+	/*
+	 * A batched scan looks the new key up in its window of keys, which stays
+	 * valid, as the query only depends on the bounds of the window.
+	 */
+	festate->rescan_started = false;
+
+	/* The rows of a rescan cut short are not its whole result */
+	if (festate->rescan_cache_fill)
+		mysql_rescan_cache_drop_fill(festate);
 }
 
 /*
@@ -1166,9 +3050,10 @@ mysqlGetForeignRelSize(PlannerInfo *root, RelOptInfo *baserel,
 	options = mysql_get_options(foreigntableid, true);
 
 	/* Connect to the server */
-	conn = mysql_get_connection(server, user, options);
+	conn = mysql_get_connection(server, user, options,
+								mysql_query_is_read_only(root));
 
-	mysql_query(conn, "SET sql_mode='ANSI_QUOTES'");
+	mysql_set_session(conn, mysql_get_conn_state(conn));
 
 	/* Base foreign tables need to be pushed down always. */
 	fpinfo->pushdown_safe = true;
@@ -1186,6 +3071,13 @@ mysqlGetForeignRelSize(PlannerInfo *root, RelOptInfo *baserel,
 	fpinfo->fdw_tuple_cost = DEFAULT_FDW_TUPLE_COST;
 	fpinfo->shippable_extensions = NIL;
 	fpinfo->fetch_size = 100;
+	fpinfo->scan_mode = MYSQL_SCAN_MODE_CURSOR;
+	fpinfo->parallel_workers = 0;
+	fpinfo->rescan_batch_size = 0;
+	fpinfo->rescan_cache = false;
+#if PG_VERSION_NUM >= 140000
+	fpinfo->async_capable = false;
+#endif
 
 	apply_server_options(fpinfo);
 	apply_table_options(fpinfo);
@@ -1374,7 +3266,7 @@ mysql_is_column_unique(Oid foreigntableid)
 	options = mysql_get_options(foreigntableid, true);
 
 	/* Connect to the server */
-	conn = mysql_get_connection(server, user, options);
+	conn = mysql_get_connection(server, user, options, false);
 
 	/* Build the query */
 	initStringInfo(&sql);
@@ -1386,7 +3278,7 @@ mysql_is_column_unique(Oid foreigntableid)
 	appendStringInfo(&sql, "EXPLAIN %s.%s",
 					 mysql_quote_identifier(options->svr_database, '`'),
 					 mysql_quote_identifier(options->svr_table, '`'));
-	if (mysql_query(conn, sql.data) != 0)
+	if (mysql_run_query(conn, sql.data) != 0)
 		mysql_error_print(conn);
 
 	result = mysql_store_result(conn);
@@ -1425,16 +3317,41 @@ mysqlEstimateCosts(PlannerInfo *root, RelOptInfo *baserel, Cost *startup_cost,
 	/* Fetch options */
 	options = mysql_get_options(foreigntableid, true);
 
-	/* Local databases are probably faster */
-	if (strcmp(options->svr_address, "127.0.0.1") == 0 ||
-		strcmp(options->svr_address, "localhost") == 0)
-		*startup_cost = 10;
-	else
-		*startup_cost = 25;
+	*startup_cost = mysql_startup_cost(options);
 
 	*total_cost = baserel->rows + *startup_cost;
 }
 
+/*
+ * mysql_startup_cost
+ * 		Startup cost of a scan of a foreign table, from the way its server is
+ * 		reached
+ *
+ * Local databases are probably faster, all the more when reached through a
+ * Unix-domain socket, a named pipe or shared memory rather than the TCP
+ * loopback.
+ */
+static int
+mysql_startup_cost(mysql_opt * options)
+{
+	switch (options->transport)
+	{
+		case MYSQL_TRANSPORT_SOCKET:
+		case MYSQL_TRANSPORT_PIPE:
+		case MYSQL_TRANSPORT_MEMORY:
+			return MYSQL_LOCAL_TRANSPORT_STARTUP_COST;
+		default:
+			break;
+	}
+
+	if (strcmp(options->svr_address, "127.0.0.1") == 0 ||
+		strcmp(options->svr_address, "::1") == 0 ||
+		pg_strcasecmp(options->svr_address, "localhost") == 0)
+		return MYSQL_LOOPBACK_STARTUP_COST;
+
+	return MYSQL_REMOTE_STARTUP_COST;
+}
+
 /*
  * mysqlGetForeignPaths
  * 		Get the foreign paths
@@ -1466,6 +3383,43 @@ mysqlGetForeignPaths(PlannerInfo *root, RelOptInfo *baserel,
 									 NULL,	/* no extra plan */
 									 NULL));	/* no fdw_private data */
 
+	/*
+	 * Consider a parallel scan, whose processes each read ranges of the
+	 * foreign table's key.  Like for UPDATE and DELETE, the key is the first
+	 * column; it must be of an integer type to be split in ranges.
+	 */
+	if (baserel->consider_parallel && fpinfo->parallel_workers > 0 &&
+		max_parallel_workers_per_gather > 0 &&
+		bms_is_empty(baserel->lateral_relids))
+	{
+		Oid			keytype = get_atttype(foreigntableid, 1);
+
+		if (keytype == INT2OID || keytype == INT4OID || keytype == INT8OID)
+		{
+			int			parallel_workers = Min(fpinfo->parallel_workers,
+											   max_parallel_workers_per_gather);
+			double		divisor = mysql_parallel_divisor(parallel_workers);
+
+			/*
+			 * The rows and the run cost are shared among the processes, but
+			 * the range of keys has to be looked up first.
+			 */
+			path = create_foreignscan_path(root, baserel,
+										   NULL,	/* default pathtarget */
+										   clamp_row_est(fpinfo->rows / divisor),
+										   fpinfo->startup_cost + fpinfo->fdw_startup_cost,
+										   fpinfo->startup_cost + fpinfo->fdw_startup_cost +
+										   (fpinfo->total_cost - fpinfo->startup_cost) / divisor,
+										   NIL, /* no pathkeys */
+										   NULL,	/* no outer rel either */
+										   NULL,	/* no extra plan */
+										   NIL);	/* no fdw_private data */
+			path->path.parallel_aware = true;
+			path->path.parallel_workers = parallel_workers;
+			add_partial_path(baserel, (Path *) path);
+		}
+	}
+
 	/* Add paths with pathkeys */
 	add_paths_with_pathkeys_for_rel(root, baserel, NULL);
 
@@ -1673,6 +3627,10 @@ mysqlGetForeignPlan(PlannerInfo *root, RelOptInfo *foreignrel,
 	List	   *scan_var_tlist = NIL;
 	List	   *fdw_scan_tlist = NIL;
 	List	   *whole_row_lists = NIL;
+	RestrictInfo *rescan_rinfo = NULL;
+	Var		   *rescan_var = NULL;
+	Expr	   *rescan_outer = NULL;
+	List	   *rescan_batch = NIL;
 
 	/* Decide to execute function pushdown support in the target list. */
 	fpinfo->is_tlist_func_pushdown = mysql_is_foreign_function_tlist(root, foreignrel, tlist);
@@ -1745,6 +3703,34 @@ mysqlGetForeignPlan(PlannerInfo *root, RelOptInfo *foreignrel,
 				local_exprs = lappend(local_exprs, rinfo->clause);
 		}
 
+		/*
+		 * A parameterized scan whose parameter is compared for equality with
+		 * an integer column can read the rows of a window of keys at once, so
+		 * that the following rescans, which a nested loop often makes with
+		 * close keys, are answered without sending another query.  The join
+		 * clause is then replaced by a condition on the window, and the key
+		 * column has to be fetched to sort the rows out.
+		 */
+		if (best_path->path.param_info && best_path->path.pathkeys == NIL &&
+			fpinfo->rescan_batch_size > 1 &&
+			!best_path->path.parallel_aware &&
+			!fpinfo->is_tlist_func_pushdown &&
+			root->parse->commandType == CMD_SELECT &&
+			root->rowMarks == NIL)
+			rescan_rinfo = mysql_rescan_batch_clause(root, foreignrel,
+													 remote_conds,
+													 &rescan_var,
+													 &rescan_outer);
+
+		if (rescan_rinfo)
+		{
+			remote_conds = list_delete_ptr(remote_conds, rescan_rinfo);
+			remote_exprs = list_delete_ptr(remote_exprs, rescan_rinfo->clause);
+			fpinfo->attrs_used = bms_add_member(fpinfo->attrs_used,
+												rescan_var->varattno -
+												FirstLowInvalidHeapAttributeNumber);
+		}
+
 		if (fpinfo->is_tlist_func_pushdown == true)
 		{
 			foreach(lc, tlist)
@@ -1917,6 +3903,36 @@ mysqlGetForeignPlan(PlannerInfo *root, RelOptInfo *foreignrel,
 										  has_final_sort, has_limit, false,
 										  &retrieved_attrs, &params_list);
 
+	/* A parallel scan reads one range of keys at a time */
+	if (best_path->path.parallel_aware)
+		mysql_append_parallel_range_clause(&sql, root, foreignrel,
+										   remote_exprs == NIL);
+
+	/*
+	 * A batched scan only passes the bounds of its window to the query, so
+	 * that a window stays valid across rescans.  Should the other conditions
+	 * need parameters too, the join clause is sent as usual instead.
+	 */
+	if (rescan_rinfo && params_list != NIL)
+	{
+		remote_exprs = lappend(remote_exprs, rescan_rinfo->clause);
+		params_list = NIL;
+		resetStringInfo(&sql);
+		mysql_deparse_select_stmt_for_rel(&sql, root, foreignrel, fdw_scan_tlist,
+										  remote_exprs, best_path->path.pathkeys,
+										  has_final_sort, has_limit, false,
+										  &retrieved_attrs, &params_list);
+	}
+	else if (rescan_rinfo)
+	{
+		mysql_append_rescan_batch_clause(&sql, root, foreignrel,
+										 rescan_var->varattno,
+										 remote_exprs == NIL);
+		params_list = list_make1(rescan_outer);
+		rescan_batch = list_make2_int(fpinfo->rescan_batch_size,
+									  rescan_var->varattno);
+	}
+
 	/* Remember remote_exprs for possible use by mysqlPlanDirectModify */
 	fpinfo->final_remote_exprs = remote_exprs;
 
@@ -1925,7 +3941,8 @@ mysqlGetForeignPlan(PlannerInfo *root, RelOptInfo *foreignrel,
 	 * Items in the list must match enum FdwScanPrivateIndex, above.
 	 */
 
-	fdw_private = list_make2(makeString(sql.data), retrieved_attrs);
+	fdw_private = list_make3(makeString(sql.data), retrieved_attrs,
+							 rescan_batch);
 
 	if (IS_JOIN_REL(foreignrel))
 	{
@@ -1992,13 +4009,13 @@ mysqlAnalyzeForeignTable(Relation relation, AcquireSampleRowsFunc *func,
 	Assert(options->svr_database != NULL && options->svr_table != NULL);
 
 	/* Connect to the server */
-	conn = mysql_get_connection(server, user, options);
+	conn = mysql_get_connection(server, user, options, true);
 
 	/* Build the query */
 	initStringInfo(&sql);
 	mysql_deparse_analyze(&sql, options->svr_database, options->svr_table);
 
-	if (mysql_query(conn, sql.data) != 0)
+	if (mysql_run_query(conn, sql.data) != 0)
 		mysql_error_print(conn);
 
 	result = mysql_store_result(conn);
@@ -2232,9 +4249,11 @@ mysqlBeginForeignModify(ModifyTableState *mtstate,
 	fmstate = (MySQLFdwExecState *) palloc0(sizeof(MySQLFdwExecState));
 
 	fmstate->rel = rel;
+	fmstate->instr = mysql_instr_create(estate);
+	fmstate->serverid = server->serverid;
 	fmstate->mysqlFdwOptions = mysql_get_options(foreignTableId, true);
 	fmstate->conn = mysql_get_connection(server, user,
-										 fmstate->mysqlFdwOptions);
+										 fmstate->mysqlFdwOptions, false);
 
 	fmstate->query = strVal(list_nth(fdw_private, FdwModifyPrivateUpdateSql));
 
@@ -2296,18 +4315,9 @@ mysqlBeginForeignModify(ModifyTableState *mtstate,
 	}
 	Assert(fmstate->p_nums <= n_params);
 
-	/* Initialize mysql statement */
-	fmstate->stmt = mysql_stmt_init(fmstate->conn);
-	if (!fmstate->stmt)
-		ereport(ERROR,
-				(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
-				 errmsg("failed to initialize the MySQL query: \n%s",
-						mysql_error(fmstate->conn))));
-
-	/* Prepare mysql statment */
-	if (mysql_stmt_prepare(fmstate->stmt, fmstate->query,
-						   strlen(fmstate->query)) != 0)
-		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to prepare the MySQL query");
+	/* Get the prepared mysql statement */
+	fmstate->stmt = mysql_prepare_stmt(fmstate->conn, fmstate->query,
+									   fmstate->instr);
 
 	/* Initialize auxiliary state */
 	fmstate->aux_fmstate = NULL;
@@ -2356,7 +4366,11 @@ mysql_execute_foreign_insert(EState *estate,
 	mysql_bind_buffer = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * n_params * *numSlots);
 	isnull = (bool *) palloc0(sizeof(bool) * n_params * *numSlots);
 
-	mysql_query(fmstate->conn, "SET sql_mode='ANSI_QUOTES'");
+#ifdef MYSQL_FDW_ASYNC
+	mysql_complete_pending_request(fmstate->conn);
+#endif
+
+	mysql_set_session(fmstate->conn, mysql_get_conn_state(fmstate->conn));
 
 #if PG_VERSION_NUM >= 140000
 	if (fmstate->num_slots != *numSlots)
@@ -2366,8 +4380,7 @@ mysql_execute_foreign_insert(EState *estate,
 		 * insert case
 		 */
 		if (fmstate && fmstate->stmt)
-			mysql_stmt_close(fmstate->stmt);
-		fmstate->stmt = mysql_stmt_init(fmstate->conn);
+			mysql_stmt_cache_release(fmstate->conn, fmstate->stmt, false);
 
 		/* Build INSERT string with numSlots records in its VALUES clause. */
 		initStringInfo(&sql);
@@ -2377,10 +4390,9 @@ mysql_execute_foreign_insert(EState *estate,
 								 *numSlots - 1);
 		fmstate->query = sql.data;
 
-		/* Prepare mysql statment */
-		if (mysql_stmt_prepare(fmstate->stmt, fmstate->query,
-							   strlen(fmstate->query)) != 0)
-			mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to prepare the MySQL query");
+		/* Get the prepared mysql statement */
+		fmstate->stmt = mysql_prepare_stmt(fmstate->conn, fmstate->query,
+										   fmstate->instr);
 	}
 #endif
 
@@ -2406,9 +4418,17 @@ mysql_execute_foreign_insert(EState *estate,
 		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to bind the MySQL query");
 
 	/* Execute the query */
-	if (mysql_stmt_execute(fmstate->stmt) != 0)
+	if (mysql_execute_stmt(fmstate->stmt, fmstate->serverid, fmstate->query,
+						   fmstate->instr) != 0)
 		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to execute the MySQL query");
 
+	if (fmstate->instr)
+	{
+		fmstate->instr->rows += mysql_stmt_affected_rows(fmstate->stmt);
+		fmstate->instr->batches++;
+		fmstate->instr->batch_rows += *numSlots;
+	}
+
 #if PG_VERSION_NUM >= 140000
 	fmstate->num_slots = *numSlots;
 #endif
@@ -2540,6 +4560,10 @@ mysqlExecForeignUpdate(EState *estate,
 	Form_pg_attribute attr;
 	bool		found_row_id_col = false;
 
+#ifdef MYSQL_FDW_ASYNC
+	mysql_complete_pending_request(fmstate->conn);
+#endif
+
 	n_params = list_length(fmstate->retrieved_attrs);
 
 	mysql_bind_buffer = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * n_params);
@@ -2646,9 +4670,13 @@ mysqlExecForeignUpdate(EState *estate,
 						mysql_error(fmstate->conn))));
 
 	/* Execute the query */
-	if (mysql_stmt_execute(fmstate->stmt) != 0)
+	if (mysql_execute_stmt(fmstate->stmt, fmstate->serverid, fmstate->query,
+						   fmstate->instr) != 0)
 		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to execute the MySQL query");
 
+	if (fmstate->instr)
+		fmstate->instr->rows += mysql_stmt_affected_rows(fmstate->stmt);
+
 	/* Return NULL if nothing was updated on the remote end */
 	return slot;
 }
@@ -2730,6 +4758,10 @@ mysqlExecForeignDelete(EState *estate,
 	Oid			typeoid;
 	Datum		value;
 
+#ifdef MYSQL_FDW_ASYNC
+	mysql_complete_pending_request(fmstate->conn);
+#endif
+
 	mysql_bind_buffer = (MYSQL_BIND *) palloc(sizeof(MYSQL_BIND));
 
 	/* Get the id that was passed up as a resjunk column */
@@ -2746,9 +4778,13 @@ mysqlExecForeignDelete(EState *estate,
 						mysql_error(fmstate->conn))));
 
 	/* Execute the query */
-	if (mysql_stmt_execute(fmstate->stmt) != 0)
+	if (mysql_execute_stmt(fmstate->stmt, fmstate->serverid, fmstate->query,
+						   fmstate->instr) != 0)
 		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to execute the MySQL query");
 
+	if (fmstate->instr)
+		fmstate->instr->rows += mysql_stmt_affected_rows(fmstate->stmt);
+
 	/* Return NULL if nothing was updated on the remote end */
 	return slot;
 }
@@ -2764,7 +4800,7 @@ mysqlEndForeignModify(EState *estate, ResultRelInfo *resultRelInfo)
 
 	if (festate && festate->stmt)
 	{
-		mysql_stmt_close(festate->stmt);
+		mysql_stmt_cache_release(festate->conn, festate->stmt, false);
 		festate->stmt = NULL;
 	}
 }
@@ -3117,6 +5153,7 @@ mysqlBeginDirectModify(ForeignScanState *node, int eflags)
 	 */
 	dmstate = (MySQLFdwDirectModifyState *) palloc0(sizeof(MySQLFdwDirectModifyState));
 	node->fdw_state = (void *) dmstate;
+	dmstate->instr = mysql_instr_create(estate);
 
 	/*
 	 * Identify which user to do the remote access as.  This should match what
@@ -3145,12 +5182,13 @@ mysqlBeginDirectModify(ForeignScanState *node, int eflags)
 	user = GetUserMapping(userid, server->serverid);
 
 	options = mysql_get_options(foreignTableId, true);
+	dmstate->serverid = server->serverid;
 
 	/*
 	 * Get connection to the foreign server.  Connection manager will
 	 * establish new connection if necessary.
 	 */
-	dmstate->conn = mysql_get_connection(server, user, options);
+	dmstate->conn = mysql_get_connection(server, user, options, false);
 
 	/* Update the foreign-join-related fields. */
 	if (fsplan->scan.scanrelid == 0)
@@ -3185,17 +5223,9 @@ mysqlBeginDirectModify(ForeignScanState *node, int eflags)
 											  "mysql_fdw temporary data",
 											  ALLOCSET_SMALL_SIZES);
 
-	/* Initialize the MySQL statement */
-	dmstate->stmt = mysql_stmt_init(dmstate->conn);
-	if (dmstate->stmt == NULL)
-		ereport(ERROR,
-				(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
-				 errmsg("failed to initialize the mysql query: \n%s",
-						mysql_error(dmstate->conn))));
-
-	/* Prepare mysql statement */
-	if (mysql_stmt_prepare(dmstate->stmt, dmstate->query, strlen(dmstate->query)) != 0)
-		mysql_stmt_error_print(dmstate->conn, dmstate->stmt, "failed to prepare the MySQL query");
+	/* Get the prepared MySQL statement */
+	dmstate->stmt = mysql_prepare_stmt(dmstate->conn, dmstate->query,
+									   dmstate->instr);
 
 	/*
 	 * Prepare for processing of parameters used in remote query, if any.
@@ -3258,7 +5288,7 @@ mysqlEndDirectModify(ForeignScanState *node)
 
 	if (dmstate && dmstate->stmt)
 	{
-		mysql_stmt_close(dmstate->stmt);
+		mysql_stmt_cache_release(dmstate->conn, dmstate->stmt, false);
 		dmstate->stmt = NULL;
 	}
 
@@ -3288,6 +5318,11 @@ mysqlExplainForeignModify(ModifyTableState *mtstate,
 			ExplainPropertyInteger("Batch Size", NULL, rinfo->ri_BatchSize, es);
 #endif
 	}
+
+	/* Show the remote work of the modification under ANALYZE */
+	if (rinfo->ri_FdwState != NULL)
+		mysql_explain_instr(((MySQLFdwExecState *) rinfo->ri_FdwState)->instr,
+							false, es);
 }
 
 /*
@@ -3308,6 +5343,11 @@ mysqlExplainDirectModify(ForeignScanState *node,
 		sql = strVal(list_nth(fdw_private, FdwDirectModifyPrivateUpdateSql));
 		ExplainPropertyText("remote query", sql, es);
 	}
+
+	/* Show the remote work of the modification under ANALYZE */
+	if (node->fdw_state != NULL)
+		mysql_explain_instr(((MySQLFdwDirectModifyState *) node->fdw_state)->instr,
+							false, es);
 }
 
 /*
@@ -3397,14 +5437,14 @@ mysqlExecForeignTruncate(List *rels,
 	 */
 	user = GetUserMapping(GetUserId(), serverid);
 	options = mysql_get_options(serverid, false);
-	conn = mysql_get_connection(server, user, options);
+	conn = mysql_get_connection(server, user, options, false);
 
 	/* Construct the TRUNCATE command string */
 	initStringInfo(&sql);
 	mysql_deparse_truncate_sql(&sql, rels);
 
 	/* Issue the TRUNCATE command to remote server */
-	mysql_query(conn, sql.data);
+	mysql_run_query(conn, sql.data);
 
 	pfree(sql.data);
 }
@@ -3459,7 +5499,7 @@ mysqlImportForeignSchema(ImportForeignSchemaStmt *stmt, Oid serverOid)
 	server = GetForeignServer(serverOid);
 	user = GetUserMapping(GetUserId(), server->serverid);
 	options = mysql_get_options(serverOid, false);
-	conn = mysql_get_connection(server, user, options);
+	conn = mysql_get_connection(server, user, options, true);
 
 	/* Create workspace for strings */
 	initStringInfo(&buf);
@@ -3469,7 +5509,7 @@ mysqlImportForeignSchema(ImportForeignSchemaStmt *stmt, Oid serverOid)
 					 "SELECT 1 FROM information_schema.TABLES WHERE TABLE_SCHEMA = '%s'",
 					 stmt->remote_schema);
 
-	if (mysql_query(conn, buf.data) != 0)
+	if (mysql_run_query(conn, buf.data) != 0)
 		mysql_error_print(conn);
 
 	res = mysql_store_result(conn);
@@ -3562,7 +5602,7 @@ mysqlImportForeignSchema(ImportForeignSchemaStmt *stmt, Oid serverOid)
 	appendStringInfo(&buf, " ORDER BY t.TABLE_NAME, c.ORDINAL_POSITION");
 
 	/* Fetch the data */
-	if (mysql_query(conn, buf.data) != 0)
+	if (mysql_run_query(conn, buf.data) != 0)
 		mysql_error_print(conn);
 
 	res = mysql_store_result(conn);
@@ -3810,9 +5850,11 @@ mysqlBeginForeignInsert(ModifyTableState *mtstate,
 	fmstate = (MySQLFdwExecState *) palloc0(sizeof(MySQLFdwExecState));
 
 	fmstate->rel = rel;
+	fmstate->instr = mysql_instr_create(estate);
+	fmstate->serverid = server->serverid;
 	fmstate->mysqlFdwOptions = mysql_get_options(foreignTableId, true);
 	fmstate->conn = mysql_get_connection(server, user,
-										 fmstate->mysqlFdwOptions);
+										 fmstate->mysqlFdwOptions, false);
 	fmstate->query = sql.data;
 	fmstate->retrieved_attrs = targetAttrs;
 	n_params = list_length(fmstate->retrieved_attrs);
@@ -3839,18 +5881,9 @@ mysqlBeginForeignInsert(ModifyTableState *mtstate,
 	}
 	Assert(fmstate->p_nums <= n_params);
 
-	/* Initialize mysql statment */
-	fmstate->stmt = mysql_stmt_init(fmstate->conn);
-	if (!fmstate->stmt)
-		ereport(ERROR,
-				(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
-				 errmsg("failed to initialize the MySQL query: \n%s",
-						mysql_error(fmstate->conn))));
-
-	/* Prepare mysql statment */
-	if (mysql_stmt_prepare(fmstate->stmt, fmstate->query,
-						   strlen(fmstate->query)) != 0)
-		mysql_stmt_error_print(fmstate->conn, fmstate->stmt, "failed to prepare the MySQL query");
+	/* Get the prepared mysql statement */
+	fmstate->stmt = mysql_prepare_stmt(fmstate->conn, fmstate->query,
+									   fmstate->instr);
 
 #if PG_VERSION_NUM >= 140000
 	fmstate->query = pstrdup(fmstate->query);
@@ -3898,7 +5931,7 @@ mysqlEndForeignInsert(EState *estate, ResultRelInfo *resultRelInfo)
 
 	if (fmstate && fmstate->stmt)
 	{
-		mysql_stmt_close(fmstate->stmt);
+		mysql_stmt_cache_release(fmstate->conn, fmstate->stmt, false);
 		fmstate->stmt = NULL;
 	}
 }
@@ -4029,22 +6062,28 @@ process_query_params(ExprContext *econtext,
 	{
 		ExprState  *expr_state = (ExprState *) lfirst(lc);
 		Datum		expr_value;
-		bool		isNull;
+		bool	   *isNull;
+
+		/*
+		 * The bind keeps a pointer to the NULL indicator until the statement
+		 * is executed, so each parameter needs its own.
+		 */
+		isNull = (bool *) palloc(sizeof(bool));
 
 		/* Evaluate the parameter expression */
 #if PG_VERSION_NUM >= 100000
-		expr_value = ExecEvalExpr(expr_state, econtext, &isNull);
+		expr_value = ExecEvalExpr(expr_state, econtext, isNull);
 #else
-		expr_value = ExecEvalExpr(expr_state, econtext, &isNull, NULL);
+		expr_value = ExecEvalExpr(expr_state, econtext, isNull, NULL);
 #endif
 		mysql_bind_sql_var(param_types[i], i, expr_value, *mysql_bind_buf,
-						   &isNull);
+						   isNull);
 
 		/*
 		 * Get string representation of each parameter value by invoking
 		 * type-specific output function, unless the value is null.
 		 */
-		if (isNull)
+		if (*isNull)
 			param_values[i] = NULL;
 		else
 			param_values[i] = OutputFunctionCall(&param_flinfo[i], expr_value);
@@ -4054,95 +6093,215 @@ process_query_params(ExprContext *econtext,
 
 /*
  * Process the query params and bind the same with the statement, if any.
- * Also, execute the statement.
  */
 static void
-bind_stmt_params_and_exec(ForeignScanState *node)
+bind_stmt_params(ForeignScanState *node)
 {
 	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
 	ExprContext *econtext = node->ss.ps.ps_ExprContext;
 	int			numParams = festate->numParams;
 	const char **values = festate->param_values;
 	MYSQL_BIND *mysql_bind_buffer = NULL;
+	int			numBinds;
+
+	/*
+	 * A parallel scan also passes the range of keys to read, and a batched
+	 * parameterized scan the window of keys to read.
+	 */
+	numBinds = numParams + (festate->is_parallel ? 3 : 0);
+	numBinds += (festate->rescan_batch_size > 0 ? 2 : 0);
 
 	/*
 	 * Construct array of query parameter values in text format.  We do the
 	 * conversions in the short-lived per-tuple context, so as not to cause a
 	 * memory leak over repeated scans.
 	 */
-	if (numParams > 0)
+	if (numBinds > 0)
 	{
 		MemoryContext oldcontext;
 
 		oldcontext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
 
-		mysql_bind_buffer = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * numParams);
+		mysql_bind_buffer = (MYSQL_BIND *) palloc0(sizeof(MYSQL_BIND) * numBinds);
 
-		process_query_params(econtext,
-							 festate->param_flinfo,
-							 festate->param_exprs,
-							 values,
-							 &mysql_bind_buffer,
-							 festate->param_types);
+		if (numParams > 0)
+			process_query_params(econtext,
+								 festate->param_flinfo,
+								 festate->param_exprs,
+								 values,
+								 &mysql_bind_buffer,
+								 festate->param_types);
+
+		if (festate->is_parallel)
+		{
+			mysql_bind_sql_var(INT8OID, numParams,
+							   Int64GetDatum(festate->range_lo),
+							   mysql_bind_buffer, &festate->range_isnull);
+			mysql_bind_sql_var(INT8OID, numParams + 1,
+							   Int64GetDatum(festate->range_hi),
+							   mysql_bind_buffer, &festate->range_isnull);
+			mysql_bind_sql_var(INT4OID, numParams + 2,
+							   Int32GetDatum(festate->range_nulls),
+							   mysql_bind_buffer, &festate->range_isnull);
+		}
+
+		if (festate->rescan_batch_size > 0)
+		{
+			mysql_bind_sql_var(INT8OID, numParams,
+							   Int64GetDatum(festate->rescan_lo),
+							   mysql_bind_buffer, &festate->rescan_isnull);
+			mysql_bind_sql_var(INT8OID, numParams + 1,
+							   Int64GetDatum(festate->rescan_hi),
+							   mysql_bind_buffer, &festate->rescan_isnull);
+		}
 
 		mysql_stmt_bind_param(festate->stmt, mysql_bind_buffer);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
+}
+
+/*
+ * Bind the query params with the statement, if any, and execute it.
+ */
+static void
+bind_stmt_params_and_exec(ForeignScanState *node)
+{
+	MySQLFdwExecState *festate = (MySQLFdwExecState *) node->fdw_state;
+
+	bind_stmt_params(node);
+	mysql_execute_scan(festate);
+}
 
+/*
+ * mysql_execute_scan
+ * 		Execute the query of a scan, whose params are already bound
+ */
+static void
+mysql_execute_scan(MySQLFdwExecState * festate)
+{
 	/*
 	 * Finally, execute the query. The result will be placed in the array we
 	 * already bind.
 	 */
-	if (mysql_stmt_execute(festate->stmt) != 0)
-	{
+	mysql_scan_stat_start(festate);
+
+	if (mysql_execute_stmt(festate->stmt, InvalidOid, NULL,
+						   festate->instr) != 0)
 		mysql_stmt_error_print(festate->conn, festate->stmt, "failed to execute the MySQL query");
+
+	mysql_scan_executed(festate);
+}
+
+/*
+ * mysql_scan_executed
+ * 		Get the result of a scan's query ready to be fetched, once it has
+ * 		been executed
+ */
+static void
+mysql_scan_executed(MySQLFdwExecState * festate)
+{
+	/* A buffered scan reads the whole result right away */
+	if (festate->scan_mode == MYSQL_SCAN_MODE_BUFFERED)
+	{
+		int			rc;
+
+		pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_FETCH));
+		rc = mysql_stmt_store_result(festate->stmt);
+		pgstat_report_wait_end();
+
+		if (rc != 0)
+			mysql_stmt_error_print(festate->conn, festate->stmt, "failed to store the MySQL query result");
 	}
+
+	/*
+	 * The result of a stream scan is still pending on the connection, so its
+	 * warnings are checked once all rows are read.
+	 */
+	if (festate->scan_mode == MYSQL_SCAN_MODE_STREAM)
+		festate->rows_pending = true;
 	else
+		mysql_check_warnings(festate->conn);
+	festate->cursor_open = (festate->scan_mode == MYSQL_SCAN_MODE_CURSOR);
+
+	/* Mark the query as executed */
+	festate->query_executed = true;
+}
+
+/*
+ * mysql_check_warnings
+ * 		Raise an error if the last statement on the connection gave a
+ * 		"Division by 0" warning
+ */
+static void
+mysql_check_warnings(MYSQL * conn)
+{
+	/* Check the results of query has warning or not */
+	if (mysql_warning_count(conn) > 0)
 	{
-		/* Check the results of query has warning or not */
-		if (mysql_warning_count(festate->conn) > 0)
+		MYSQL_RES  *result = NULL;
+
+		if (mysql_run_query(conn, "SHOW WARNINGS"))
 		{
-			MYSQL_RES  *result = NULL;
+			mysql_error_print(conn);
+		}
+		result = mysql_store_result(conn);
+		if (result)
+		{
+			/*
+			 * MySQL provide numbers of rows per table invole in the
+			 * statment, but we don't have problem with it because we are
+			 * sending separate query per table in FDW.
+			 */
+			MYSQL_ROW	row;
+			unsigned int num_fields;
+			unsigned int i;
 
-			if (mysql_query(festate->conn, "SHOW WARNINGS"))
+			num_fields = mysql_num_fields(result);
+			while ((row = mysql_fetch_row(result)))
 			{
-				mysql_error_print(festate->conn);
-			}
-			result = mysql_store_result(festate->conn);
-			if (result)
-			{
-				/*
-				 * MySQL provide numbers of rows per table invole in the
-				 * statment, but we don't have problem with it because we are
-				 * sending separate query per table in FDW.
-				 */
-				MYSQL_ROW	row;
-				unsigned int num_fields;
-				unsigned int i;
-
-				num_fields = mysql_num_fields(result);
-				while ((row = mysql_fetch_row(result)))
+				for (i = 0; i < num_fields; i++)
 				{
-					for (i = 0; i < num_fields; i++)
-					{
-						/* Check warning of query */
-						if (strcmp(row[i], "Division by 0") == 0)
-							ereport(ERROR,
-									(errcode(ERRCODE_DIVISION_BY_ZERO),
-									 errmsg("division by zero")));
-					}
+					/* Check warning of query */
+					if (strcmp(row[i], "Division by 0") == 0)
+						ereport(ERROR,
+								(errcode(ERRCODE_DIVISION_BY_ZERO),
+								 errmsg("division by zero")));
 				}
-				mysql_free_result(result);
 			}
+			mysql_free_result(result);
 		}
 	}
+}
+
+/*
+ * mysql_get_bytes_sent
+ * 		Get the number of bytes the server has sent on the connection, or -1
+ * 		if it cannot be known
+ *
+ * On a compressed connection, these are the compressed bytes.
+ */
+static int64
+mysql_get_bytes_sent(MYSQL * conn)
+{
+	MYSQL_RES  *result;
+	MYSQL_ROW	row;
+	int64		bytes = -1;
 
+	if (mysql_run_query(conn, "SHOW SESSION STATUS LIKE 'Bytes_sent'") != 0)
+		return -1;
 
-	/* Mark the query as executed */
-	festate->query_executed = true;
-}
+	result = mysql_store_result(conn);
+	if (result == NULL)
+		return -1;
+
+	row = mysql_fetch_row(result);
+	if (row != NULL && row[1] != NULL)
+		bytes = strtoll(row[1], NULL, 10);
+	mysql_free_result(result);
 
+	return bytes;
+}
 
 /*
  * Execute a direct UPDATE/DELETE statement.
@@ -4156,6 +6315,10 @@ execute_dml_stmt(ForeignScanState *node)
 	const char **values = dmstate->param_values;
 	MYSQL_BIND *mysql_bind_buffer = NULL;
 
+#ifdef MYSQL_FDW_ASYNC
+	mysql_complete_pending_request(dmstate->conn);
+#endif
+
 	/*
 	 * Construct array of query parameter values in text format.
 	 */
@@ -4178,11 +6341,14 @@ execute_dml_stmt(ForeignScanState *node)
 	 * Finally, execute the query. The result will be placed in the array we
 	 * already bind.
 	 */
-	if (mysql_stmt_execute(dmstate->stmt) != 0)
+	if (mysql_execute_stmt(dmstate->stmt, dmstate->serverid, dmstate->query,
+						   dmstate->instr) != 0)
 		mysql_stmt_error_print(dmstate->conn, dmstate->stmt, "failed to execute the MySQL query");
 
 	/* Get the number of rows affected. */
 	dmstate->num_tuples = mysql_stmt_affected_rows(dmstate->stmt);
+	if (dmstate->instr)
+		dmstate->instr->rows += dmstate->num_tuples;
 }
 
 
@@ -4224,6 +6390,378 @@ mysql_error_print(MYSQL * conn)
 	}
 }
 
+/*
+ * mysql_prepare_stmt
+ * 		Get a statement prepared from query on conn, taken from the prepared
+ * 		statement cache of the connection when possible.
+ *
+ * The statement is to be given back with mysql_stmt_cache_release.  The
+ * statements actually prepared are counted in instr, if given.
+ */
+static MYSQL_STMT *
+mysql_prepare_stmt(MYSQL * conn, const char *query,
+				   MySQLInstrumentation *instr)
+{
+	MYSQL_STMT *stmt;
+	int			rc;
+
+	stmt = mysql_stmt_cache_lookup(conn, query);
+	if (stmt != NULL)
+		return stmt;
+
+	if (instr)
+	{
+		instr->prepares++;
+		instr->round_trips++;
+	}
+
+	/* Initialize the MySQL statement */
+	stmt = mysql_stmt_init(conn);
+	if (stmt == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
+				 errmsg("failed to initialize the MySQL query: \n%s",
+						mysql_error(conn))));
+
+	/* Prepare MySQL statement */
+	pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_PREPARE));
+	rc = mysql_stmt_prepare(stmt, query, strlen(query));
+	pgstat_report_wait_end();
+
+	if (rc != 0)
+		mysql_stmt_error_print(conn, stmt, "failed to prepare the MySQL query");
+
+	mysql_stmt_cache_insert(conn, query, stmt);
+
+	return stmt;
+}
+
+/*
+ * mysql_execute_stmt
+ * 		Execute a prepared statement, counting the execution in instr, if
+ * 		given
+ *
+ * A statement that returns no rows is also counted in the remote query
+ * statistics when its query text is given, with the rows it affected.
+ * Scans count their query once its result has been read.
+ *
+ * Returns the result of mysql_stmt_execute.
+ */
+static int
+mysql_execute_stmt(MYSQL_STMT * stmt, Oid serverid, const char *query,
+				   MySQLInstrumentation *instr)
+{
+	bool		track = (query != NULL && mysql_stat_enabled());
+	instr_time	start;
+	instr_time	elapsed;
+	int			rc;
+
+	if (instr == NULL && !track)
+	{
+		pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_EXECUTE));
+		rc = mysql_stmt_execute(stmt);
+		pgstat_report_wait_end();
+
+		return rc;
+	}
+
+	INSTR_TIME_SET_ZERO(start);
+	INSTR_TIME_SET_ZERO(elapsed);
+
+	if (track || instr->need_timer)
+		INSTR_TIME_SET_CURRENT(start);
+
+	pgstat_report_wait_start(mysql_wait_event(MYSQL_WAIT_EVENT_EXECUTE));
+	rc = mysql_stmt_execute(stmt);
+	pgstat_report_wait_end();
+
+	if (track || instr->need_timer)
+	{
+		INSTR_TIME_SET_CURRENT(elapsed);
+		INSTR_TIME_SUBTRACT(elapsed, start);
+	}
+
+	if (instr)
+	{
+		instr->executes++;
+		instr->round_trips++;
+		instr->result_rows = 0;
+		if (instr->need_timer)
+			INSTR_TIME_ADD(instr->execute_time, elapsed);
+	}
+
+	if (track)
+		mysql_stat_record(serverid, query, INSTR_TIME_GET_MILLISEC(elapsed),
+						  rc == 0 ? (int64) mysql_stmt_affected_rows(stmt) : 0,
+						  0);
+
+	return rc;
+}
+
+/*
+ * mysql_scan_stat_start
+ * 		Start counting the query of a scan in the remote query statistics,
+ * 		as it is executed
+ *
+ * The time of a scan's query runs from its execution until its result has
+ * been read.
+ */
+static void
+mysql_scan_stat_start(MySQLFdwExecState * festate)
+{
+	/* The previous result of the scan may not have been read entirely */
+	mysql_scan_stat_end(festate);
+
+	if (!mysql_stat_enabled())
+		return;
+
+	festate->stat_pending = true;
+	festate->stat_rows = 0;
+	festate->stat_bytes = 0;
+	INSTR_TIME_SET_CURRENT(festate->stat_start);
+}
+
+/*
+ * mysql_scan_stat_end
+ * 		Count the query of a scan in the remote query statistics, once its
+ * 		result has been read or abandoned
+ */
+static void
+mysql_scan_stat_end(MySQLFdwExecState * festate)
+{
+	instr_time	elapsed;
+
+	if (!festate->stat_pending)
+		return;
+
+	festate->stat_pending = false;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, festate->stat_start);
+
+	mysql_stat_record(festate->serverid, festate->query,
+					  INSTR_TIME_GET_MILLISEC(elapsed), festate->stat_rows,
+					  festate->stat_bytes);
+}
+
+/*
+ * mysql_instr_create
+ * 		Get the counters of the remote work of a scan or modification, when
+ * 		the query runs under EXPLAIN ANALYZE
+ *
+ * Returns NULL if the query is not instrumented.
+ */
+static MySQLInstrumentation *
+mysql_instr_create(EState *estate)
+{
+	MySQLInstrumentation *instr;
+
+	if (estate->es_instrument == 0)
+		return NULL;
+
+	instr = (MySQLInstrumentation *) palloc0(sizeof(MySQLInstrumentation));
+	instr->need_timer = (estate->es_instrument & INSTRUMENT_TIMER) != 0;
+
+	return instr;
+}
+
+/*
+ * mysql_instr_accum
+ * 		Add the time elapsed since start to total
+ */
+static void
+mysql_instr_accum(MySQLInstrumentation *instr, instr_time *total,
+				  instr_time start)
+{
+	instr_time	end;
+
+	Assert(instr->need_timer);
+
+	INSTR_TIME_SET_CURRENT(end);
+	INSTR_TIME_ACCUM_DIFF(*total, end, start);
+}
+
+/*
+ * mysql_explain_instr
+ * 		Show the remote work of a scan or modification under EXPLAIN ANALYZE
+ *
+ * The times tell whether a slow scan waits for the server to execute its
+ * query, for the rows to come over the network, or for their values to be
+ * converted.
+ */
+static void
+mysql_explain_instr(MySQLInstrumentation *instr, bool is_scan,
+					ExplainState *es)
+{
+	if (instr == NULL || !es->analyze)
+		return;
+
+	if (es->timing && instr->need_timer)
+	{
+#if PG_VERSION_NUM >= 110000
+		ExplainPropertyFloat("Remote execute time", "ms",
+							 INSTR_TIME_GET_MILLISEC(instr->execute_time),
+							 3, es);
+		if (is_scan)
+		{
+			ExplainPropertyFloat("Remote fetch time", "ms",
+								 INSTR_TIME_GET_MILLISEC(instr->fetch_time),
+								 3, es);
+			ExplainPropertyFloat("Conversion time", "ms",
+								 INSTR_TIME_GET_MILLISEC(instr->convert_time),
+								 3, es);
+		}
+#else
+		ExplainPropertyFloat("Remote execute time",
+							 INSTR_TIME_GET_MILLISEC(instr->execute_time),
+							 3, es);
+		if (is_scan)
+		{
+			ExplainPropertyFloat("Remote fetch time",
+								 INSTR_TIME_GET_MILLISEC(instr->fetch_time),
+								 3, es);
+			ExplainPropertyFloat("Conversion time",
+								 INSTR_TIME_GET_MILLISEC(instr->convert_time),
+								 3, es);
+		}
+#endif
+	}
+
+#if PG_VERSION_NUM >= 110000
+	if (is_scan)
+	{
+		ExplainPropertyInteger("Rows fetched", NULL, instr->rows, es);
+		ExplainPropertyInteger("Bytes fetched", NULL, instr->bytes, es);
+		if (instr->compressed && instr->bytes_received >= 0)
+			ExplainPropertyInteger("Compressed bytes received", NULL,
+								   instr->bytes_received, es);
+	}
+	else
+		ExplainPropertyInteger("Rows modified", NULL, instr->rows, es);
+	ExplainPropertyInteger("Remote round trips", NULL, instr->round_trips, es);
+	ExplainPropertyInteger("Remote prepares", NULL, instr->prepares, es);
+	ExplainPropertyInteger("Remote executes", NULL, instr->executes, es);
+	if (instr->batches > 0)
+	{
+		ExplainPropertyInteger("Batches sent", NULL, instr->batches, es);
+		ExplainPropertyFloat("Rows per batch", NULL,
+							 (double) instr->batch_rows / instr->batches,
+							 1, es);
+	}
+#else
+	if (is_scan)
+	{
+		ExplainPropertyLong("Rows fetched", instr->rows, es);
+		ExplainPropertyLong("Bytes fetched", instr->bytes, es);
+		if (instr->compressed && instr->bytes_received >= 0)
+			ExplainPropertyLong("Compressed bytes received",
+								instr->bytes_received, es);
+	}
+	else
+		ExplainPropertyLong("Rows modified", instr->rows, es);
+	ExplainPropertyLong("Remote round trips", instr->round_trips, es);
+	ExplainPropertyLong("Remote prepares", instr->prepares, es);
+	ExplainPropertyLong("Remote executes", instr->executes, es);
+	if (instr->batches > 0)
+	{
+		ExplainPropertyLong("Batches sent", instr->batches, es);
+		ExplainPropertyFloat("Rows per batch",
+							 (double) instr->batch_rows / instr->batches,
+							 1, es);
+	}
+#endif
+}
+
+/*
+ * mysql_set_session
+ * 		Bring the session variables of a connection to the values wanted,
+ * 		sending one SET for the ones that are not set already.
+ *
+ * The session timeouts come from the mysql_fdw.wait_timeout and
+ * mysql_fdw.interactive_timeout settings, and are left alone when these
+ * are 0.  The variables go in a single SET, as each SET is a round trip;
+ * the server applies none of them if it refuses one.  A refused SET is
+ * reported as a warning, and the values recorded all the same, so that it
+ * is not sent again on every scan of the session.
+ */
+static void
+mysql_set_session(MYSQL * conn, MySQLConnState *state)
+{
+	MySQLConnState local_state;
+	StringInfoData sql;
+
+	/* Without a state to track them, the variables are always set */
+	if (state == NULL)
+	{
+		MemSet(&local_state, 0, sizeof(MySQLConnState));
+		state = &local_state;
+	}
+
+	mysql_check_conn_state(conn, state);
+
+	initStringInfo(&sql);
+
+	if (wait_timeout > 0 && state->wait_timeout != wait_timeout)
+		appendStringInfo(&sql, "%s wait_timeout = %d",
+						 sql.len > 0 ? "," : "SET", wait_timeout);
+
+	if (interactive_timeout > 0 &&
+		state->interactive_timeout != interactive_timeout)
+		appendStringInfo(&sql, "%s interactive_timeout = %d",
+						 sql.len > 0 ? "," : "SET", interactive_timeout);
+
+	if (state->sql_mode == NULL || strcmp(state->sql_mode, MYSQL_SQL_MODE) != 0)
+		appendStringInfo(&sql, "%s sql_mode = '%s'",
+						 sql.len > 0 ? "," : "SET", MYSQL_SQL_MODE);
+
+	if (sql.len > 0)
+	{
+		if (mysql_run_query(conn, sql.data) != 0)
+			elog(WARNING, "could not set session variables on MySQL server: %s",
+				 mysql_error(conn));
+
+		if (wait_timeout > 0)
+			state->wait_timeout = wait_timeout;
+		if (interactive_timeout > 0)
+			state->interactive_timeout = interactive_timeout;
+		state->sql_mode = MYSQL_SQL_MODE;
+	}
+
+	pfree(sql.data);
+}
+
+/*
+ * mysql_query_is_read_only
+ * 		Tell whether the statement being planned only reads, without locking
+ * 		rows.
+ */
+static bool
+mysql_query_is_read_only(PlannerInfo *root)
+{
+	Query	   *parse;
+
+	/* Look at the statement itself, not at one of its subqueries */
+	while (root->parent_root != NULL)
+		root = root->parent_root;
+	parse = root->parse;
+
+	return parse->commandType == CMD_SELECT && !parse->hasModifyingCTE &&
+		parse->rowMarks == NIL;
+}
+
+/*
+ * mysql_plan_is_read_only
+ * 		Same as mysql_query_is_read_only, for the statement being executed.
+ */
+static bool
+mysql_plan_is_read_only(EState *estate)
+{
+	PlannedStmt *pstmt = estate->es_plannedstmt;
+
+	return pstmt->commandType == CMD_SELECT && !pstmt->hasModifyingCTE &&
+		pstmt->rowMarks == NIL;
+}
+
 static void
 mysql_stmt_error_print(MYSQL * conn, MYSQL_STMT * stmt, const char *msg)
 {
@@ -4782,7 +7320,10 @@ estimate_path_cost_size(PlannerInfo *root,
 										  false, &retrieved_attrs, NULL);
 
 		/* Connect to the server */
-		conn = mysql_get_connection(fpinfo->server, fpinfo->user, (struct mysql_opt *) fpinfo->server->options);
+		conn = mysql_get_connection(fpinfo->server, fpinfo->user,
+									mysql_get_options(fpinfo->server->serverid,
+													  false),
+									mysql_query_is_read_only(root));
 
 		/* Get the remote estimate */
 		get_remote_estimate(sql.data, conn, &rows, &width,
@@ -5201,6 +7742,44 @@ estimate_path_cost_size(PlannerInfo *root,
 	total_cost += fpinfo->fdw_tuple_cost * retrieved_rows;
 	total_cost += cpu_tuple_cost * retrieved_rows;
 
+	/*
+	 * A batched parameterized scan sends a query for a window of keys rather
+	 * than for each rescan.  The window retrieves the rows of all its keys,
+	 * and its cost is shared by the rescans it answers.  That is one per key
+	 * at best, when the outer keys come in order and dense, but it is costed
+	 * at the fewest the scan tolerates before giving batching up.
+	 */
+	if (list_length(param_join_conds) == 1 && fpinfo->rescan_batch_size > 1 &&
+		IS_SIMPLE_REL(foreignrel) &&
+		mysql_rescan_batch_clause(root, foreignrel, param_join_conds,
+								  NULL, NULL))
+	{
+		double		window_rows = retrieved_rows * fpinfo->rescan_batch_size;
+		Cost		rescan_cost;
+		Cost		window_cost;
+
+		if (foreignrel->tuples > 0)
+			window_rows = Min(window_rows, foreignrel->tuples);
+
+		rescan_cost = fpinfo->fdw_startup_cost +
+			(fpinfo->fdw_tuple_cost + cpu_tuple_cost) * retrieved_rows;
+		window_cost = fpinfo->fdw_startup_cost +
+			(fpinfo->fdw_tuple_cost + cpu_tuple_cost) * window_rows;
+
+		startup_cost -= fpinfo->fdw_startup_cost *
+			(1.0 - 1.0 / MYSQL_RESCAN_MIN_HITS);
+		total_cost += window_cost / MYSQL_RESCAN_MIN_HITS - rescan_cost;
+	}
+
+	/*
+	 * A buffered scan transfers the whole result to the client before the
+	 * first row is returned, so the transfer cost is paid at startup.  Cursor
+	 * and stream scans hand out rows while the transfer is going on, which
+	 * is what the estimates above assume.
+	 */
+	if (fpinfo->scan_mode == MYSQL_SCAN_MODE_BUFFERED)
+		startup_cost += fpinfo->fdw_tuple_cost * retrieved_rows;
+
 	/*
 	 * If we have LIMIT, we should prefer performing the restriction remotely
 	 * rather than locally, as the former avoids extra row fetches from the
@@ -5257,7 +7836,7 @@ get_remote_estimate(const char *sql, MYSQL * conn,
 	double		filtered = 0;
 	MYSQL_ROW	row;
 
-	if (mysql_query(conn, sql) != 0)
+	if (mysql_run_query(conn, sql) != 0)
 		mysql_error_print(conn);
 
 	result = mysql_store_result(conn);
@@ -5383,6 +7962,20 @@ apply_server_options(MySQLFdwRelationInfo * fpinfo)
 							  NULL);
 		else if (strcmp(def->defname, "fetch_size") == 0)
 			(void) parse_int(defGetString(def), &fpinfo->fetch_size, 0, NULL);
+		else if (strcmp(def->defname, "scan_mode") == 0)
+			fpinfo->scan_mode = mysql_parse_scan_mode(def);
+		else if (strcmp(def->defname, "parallel_workers") == 0)
+			(void) parse_int(defGetString(def), &fpinfo->parallel_workers, 0,
+							 NULL);
+		else if (strcmp(def->defname, "rescan_batch_size") == 0)
+			(void) parse_int(defGetString(def), &fpinfo->rescan_batch_size, 0,
+							 NULL);
+		else if (strcmp(def->defname, "rescan_cache") == 0)
+			fpinfo->rescan_cache = defGetBoolean(def);
+#if PG_VERSION_NUM >= 140000
+		else if (strcmp(def->defname, "async_capable") == 0)
+			fpinfo->async_capable = defGetBoolean(def);
+#endif
 	}
 }
 
@@ -5404,6 +7997,20 @@ apply_table_options(MySQLFdwRelationInfo * fpinfo)
 			fpinfo->use_remote_estimate = defGetBoolean(def);
 		else if (strcmp(def->defname, "fetch_size") == 0)
 			(void) parse_int(defGetString(def), &fpinfo->fetch_size, 0, NULL);
+		else if (strcmp(def->defname, "scan_mode") == 0)
+			fpinfo->scan_mode = mysql_parse_scan_mode(def);
+		else if (strcmp(def->defname, "parallel_workers") == 0)
+			(void) parse_int(defGetString(def), &fpinfo->parallel_workers, 0,
+							 NULL);
+		else if (strcmp(def->defname, "rescan_batch_size") == 0)
+			(void) parse_int(defGetString(def), &fpinfo->rescan_batch_size, 0,
+							 NULL);
+		else if (strcmp(def->defname, "rescan_cache") == 0)
+			fpinfo->rescan_cache = defGetBoolean(def);
+#if PG_VERSION_NUM >= 140000
+		else if (strcmp(def->defname, "async_capable") == 0)
+			fpinfo->async_capable = defGetBoolean(def);
+#endif
 	}
 }
 
@@ -5439,6 +8046,13 @@ merge_fdw_options(MySQLFdwRelationInfo * fpinfo,
 	fpinfo->use_remote_estimate = fpinfo_o->use_remote_estimate;
 
 	fpinfo->fetch_size = fpinfo_o->fetch_size;
+	fpinfo->scan_mode = fpinfo_o->scan_mode;
+	fpinfo->parallel_workers = fpinfo_o->parallel_workers;
+	fpinfo->rescan_batch_size = fpinfo_o->rescan_batch_size;
+	fpinfo->rescan_cache = fpinfo_o->rescan_cache;
+#if PG_VERSION_NUM >= 140000
+	fpinfo->async_capable = fpinfo_o->async_capable;
+#endif
 
 	/* Merge the table level options from either side of the join. */
 	if (fpinfo_i)
@@ -5460,6 +8074,19 @@ merge_fdw_options(MySQLFdwRelationInfo * fpinfo,
 		 * relation sizes.
 		 */
 		fpinfo->fetch_size = Max(fpinfo_o->fetch_size, fpinfo_i->fetch_size);
+
+#if PG_VERSION_NUM >= 140000
+
+		/*
+		 * We'll prefer to consider this join async-capable if any table from
+		 * either side of the join is considered async-capable.  This would be
+		 * reasonable because in that case the foreign server would have its
+		 * own resources to scan that table asynchronously, and the join could
+		 * also be computed asynchronously using the resources.
+		 */
+		fpinfo->async_capable = fpinfo_o->async_capable ||
+			fpinfo_i->async_capable;
+#endif
 	}
 }
 
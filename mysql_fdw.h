@@ -35,15 +35,118 @@
 #else
 #include "nodes/pathnodes.h"
 #endif
+#include "utils/hsearch.h"
 #include "utils/rel.h"
 #include "utils/float.h"
 #include "catalog/pg_proc.h"
+#include "port/atomics.h"
+#include "portability/instr_time.h"
 
 #define MYSQL_PREFETCH_ROWS	100
+
+/*
+ * sql_mode of the session, for scans as well as planning and modifies.
+ * ERROR_FOR_DIVISION_BY_ZERO has a scan warn of "Division by 0", which is
+ * then reported as an error.  Strict modes are left out, so that a modify
+ * still stores the value MySQL adjusts an invalid one to, as it always has.
+ */
+#define MYSQL_SQL_MODE		"ANSI_QUOTES,ERROR_FOR_DIVISION_BY_ZERO"
+
+/* Default bound of the prepared statement cache of a connection */
+#define MYSQL_DEFAULT_PREPARED_STATEMENTS	100
+
+/* Idle time, in seconds, after which a cached connection is pinged */
+#define MYSQL_PING_IDLE_TIME	30
+
+/*
+ * How rows of a foreign scan are fetched from the remote server; see the
+ * scan_mode option.
+ */
+typedef enum MySQLScanMode
+{
+	MYSQL_SCAN_MODE_CURSOR,		/* read-only server-side cursor */
+	MYSQL_SCAN_MODE_STREAM,		/* unbuffered fetch on its own connection */
+	MYSQL_SCAN_MODE_BUFFERED	/* whole result stored on the client */
+} MySQLScanMode;
+
+/*
+ * How the MySQL server is reached; see the transport option.  With the
+ * default, the client library decides, from the host and socket options.
+ */
+typedef enum MySQLTransport
+{
+	MYSQL_TRANSPORT_DEFAULT,	/* TCP, or socket for host localhost */
+	MYSQL_TRANSPORT_TCP,		/* TCP/IP */
+	MYSQL_TRANSPORT_SOCKET,		/* Unix-domain socket */
+	MYSQL_TRANSPORT_PIPE,		/* Windows named pipe */
+	MYSQL_TRANSPORT_MEMORY		/* Windows shared memory */
+} MySQLTransport;
+
+/* Startup costs of a scan, depending on how the server is reached */
+#define MYSQL_LOCAL_TRANSPORT_STARTUP_COST	5
+#define MYSQL_LOOPBACK_STARTUP_COST	10
+#define MYSQL_REMOTE_STARTUP_COST	25
+
+/*
+ * How the protocol traffic of a connection is compressed; see the compression
+ * option.
+ */
+typedef enum MySQLCompression
+{
+	MYSQL_COMPRESSION_OFF,		/* no compression */
+	MYSQL_COMPRESSION_ZLIB,		/* zlib */
+	MYSQL_COMPRESSION_ZSTD		/* zstd */
+} MySQLCompression;
+
+/* Highest compression_level option, that of zstd */
+#define MYSQL_MAX_COMPRESSION_LEVEL	22
+
+/*
+ * The choice of the compression algorithm, and so zstd, came with the MySQL
+ * 8.0.18 client library; other client libraries only have zlib.
+ */
+#if MYSQL_VERSION_ID >= 80018 && !defined(MARIADB_VERSION_ID)
+#define MYSQL_FDW_COMPRESSION_ALGORITHMS
+#endif
+
+/*
+ * How the remote transaction of a connection is run; see the
+ * transaction_mode option.
+ */
+typedef enum MySQLTransactionMode
+{
+	MYSQL_TRANSACTION_MODE_TRANSACTION, /* remote transaction per local one */
+	MYSQL_TRANSACTION_MODE_AUTOCOMMIT	/* reads run in autocommit mode */
+} MySQLTransactionMode;
+
+/*
+ * How the read replica that the reads of a transaction go to is picked; see
+ * the replica_selection option.
+ */
+typedef enum MySQLReplicaSelection
+{
+	MYSQL_REPLICA_SELECTION_ROUND_ROBIN,	/* each replica in turn */
+	MYSQL_REPLICA_SELECTION_LEAST_OUTSTANDING	/* the replica the fewest
+												 * transactions read from */
+} MySQLReplicaSelection;
+
+/* Read replica of a MySQL server; see the replicas option */
+typedef struct MySQLReplica
+{
+	char	   *host;			/* address or hostname of the replica */
+	int			port;			/* its port number */
+} MySQLReplica;
 #define MYSQL_BLKSIZ		(1024 * 4)
 #define MYSQL_DEFAULT_SERVER_PORT	3306
 #define MAXDATALEN			1024 * 64
 
+/* Size of the pieces in which TEXT and BLOB values are fetched */
+#define MYSQL_LOB_CHUNK_SIZE	(1024 * 1024)
+
+/* Most rows, and bind buffer bytes, a scan fetches before converting them */
+#define MYSQL_FETCH_BATCH_ROWS	64
+#define MYSQL_FETCH_BATCH_BYTES	(1024 * 1024)
+
 #define WAIT_TIMEOUT		0
 #define INTERACTIVE_TIMEOUT 0
 
@@ -53,14 +156,24 @@
 #define MYSQL_ATTRIBUTE_GENERATED_STORED 'S'
 #endif
 
+/*
+ * Asynchronous foreign scans need the executor support of PostgreSQL 14 and
+ * the non-blocking client API, which only the MariaDB client library has.
+ */
+#if PG_VERSION_NUM >= 140000 && defined(MYSQL_WAIT_READ)
+#define MYSQL_FDW_ASYNC
+#endif
+
 #define mysql_options (*_mysql_options)
 #define mysql_stmt_prepare (*_mysql_stmt_prepare)
 #define mysql_stmt_execute (*_mysql_stmt_execute)
 #define mysql_stmt_fetch (*_mysql_stmt_fetch)
+#define mysql_stmt_fetch_column (*_mysql_stmt_fetch_column)
 #define mysql_query (*_mysql_query)
 #define mysql_stmt_attr_set (*_mysql_stmt_attr_set)
 #define mysql_stmt_close (*_mysql_stmt_close)
 #define mysql_stmt_reset (*_mysql_stmt_reset)
+#define mysql_stmt_free_result (*_mysql_stmt_free_result)
 #define mysql_free_result (*_mysql_free_result)
 #define mysql_stmt_bind_param (*_mysql_stmt_bind_param)
 #define mysql_stmt_bind_result (*_mysql_stmt_bind_result)
@@ -85,6 +198,16 @@
 #define mysql_num_rows (*_mysql_num_rows)
 #define mysql_warning_count (*_mysql_warning_count)
 #define mysql_stmt_affected_rows (*_mysql_stmt_affected_rows)
+#define mysql_thread_id (*_mysql_thread_id)
+#define mysql_ping (*_mysql_ping)
+#ifdef MYSQL_FDW_ASYNC
+#define mysql_stmt_execute_start (*_mysql_stmt_execute_start)
+#define mysql_stmt_execute_cont (*_mysql_stmt_execute_cont)
+#define mysql_get_socket (*_mysql_get_socket)
+#define mysql_get_timeout_value_ms (*_mysql_get_timeout_value_ms)
+#define mysql_real_query_start (*_mysql_real_query_start)
+#define mysql_real_query_cont (*_mysql_real_query_cont)
+#endif
 
 /*
  * FDW-specific planner information kept in RelOptInfo.fdw_private for a
@@ -152,6 +275,16 @@ typedef struct MySQLFdwRelationInfo
 	UserMapping *user;			/* only set in use_remote_estimate mode */
 
 	int			fetch_size;		/* fetch size for this remote table */
+	MySQLScanMode scan_mode;	/* how rows are fetched */
+	int			parallel_workers;	/* workers of a parallel scan */
+	int			rescan_batch_size;	/* keys read at once by a parameterized
+									 * scan */
+	bool		rescan_cache;	/* keep the rows of rescans for later ones */
+	Bitmapset  *unique_keys_checked;	/* columns whose uniqueness is known */
+	Bitmapset  *unique_keys;	/* those of them that are unique */
+#if PG_VERSION_NUM >= 140000
+	bool		async_capable;	/* can the scan run asynchronously? */
+#endif
 
 	/*
 	 * Name of the relation, for use while EXPLAINing ForeignScan.  It is used
@@ -209,6 +342,12 @@ typedef struct mysql_opt
 {
 	int			svr_port;		/* MySQL port number */
 	char	   *svr_address;	/* MySQL server ip address */
+	char	   *svr_socket;		/* Unix-domain socket, named pipe or shared
+								 * memory name, or NULL */
+	MySQLTransport transport;	/* How the server is reached */
+	List	   *replicas;		/* MySQLReplica of the read replicas, or NIL */
+	MySQLReplicaSelection replica_selection;	/* How the replica of a
+												 * transaction is picked */
 	char	   *svr_username;	/* MySQL user name */
 	char	   *svr_password;	/* MySQL password */
 	char	   *svr_database;	/* MySQL database name */
@@ -220,7 +359,22 @@ typedef struct mysql_opt
 									 * truncation */
 	bool		use_remote_estimate;	/* use remote estimate for rows */
 	unsigned long fetch_size;	/* Number of rows to fetch from remote server */
+	MySQLScanMode scan_mode;	/* How rows are fetched from remote server */
+	int			parallel_workers;	/* Workers of a parallel scan, 0 if
+									 * disabled */
+	int			max_prepared_statements;	/* Prepared statements kept per
+											 * connection, 0 if disabled */
+	int			idle_timeout;	/* Seconds an unused connection is kept, 0
+								 * for no limit */
+	int			max_connection_lifetime;	/* Seconds a connection is kept
+											 * after connecting, 0 for no
+											 * limit */
 	bool		reconnect;		/* set to true for automatic reconnection */
+	bool		rescan_cache;	/* keep the rows of rescans for later ones */
+	MySQLTransactionMode transaction_mode;	/* How remote transactions are
+											 * run */
+	MySQLCompression compression;	/* How protocol traffic is compressed */
+	int			compression_level;	/* zstd level, 0 for the default one */
 
 	char	   *column_name;	/* use column name option */
 
@@ -236,6 +390,46 @@ typedef struct mysql_opt
 								 * use for SSL encryption */
 }			mysql_opt;
 
+/*
+ * State of a MySQL connection that scans sharing it have to coordinate on.
+ * Cached connections keep it in their cache entry; the private connection of
+ * a stream scan keeps it in the scan state.
+ */
+typedef struct MySQLConnState
+{
+	MYSQL	   *conn;			/* connection the state belongs to */
+
+	/* Session variables as last set by us, or NULL/0 if not known */
+	unsigned long session_thread_id;	/* remote session they belong to */
+	const char *sql_mode;		/* sql_mode */
+	const char *autocommit;		/* autocommit, "0" or "1" */
+	const char *access_mode;	/* transaction access mode, "READ ONLY" or
+								 * "READ WRITE" */
+	int			wait_timeout;	/* wait_timeout */
+	int			interactive_timeout;	/* interactive_timeout */
+#ifdef MYSQL_FDW_ASYNC
+	AsyncRequest *pending_areq; /* scan whose query is being executed
+								 * asynchronously, or NULL */
+	MYSQL_STMT *pending_stmt;	/* statement of that scan */
+	int			pending_status; /* events the client library waits for */
+	int			pending_ret;	/* result of the execution once finished */
+#endif
+}			MySQLConnState;
+
+/*
+ * State shared by the processes running a parallel foreign scan.  The values
+ * of the key column, from lo to hi, are split in nranges ranges of width
+ * values, which the processes take in turn.
+ */
+typedef struct MySQLParallelScanState
+{
+	int64		lo;				/* lowest value of the key */
+	int64		hi;				/* highest value of the key */
+	uint64		width;			/* number of key values in a range */
+	uint64		nranges;		/* number of ranges */
+	pg_atomic_uint64 next_range;	/* next range to be scanned */
+}			MySQLParallelScanState;
+
 typedef struct mysql_column
 {
 	Datum		value;
@@ -243,6 +437,19 @@ typedef struct mysql_column
 	bool		is_null;
 	bool		error;
 	MYSQL_BIND *mysql_bind;
+	bool		is_lob;			/* bound without a buffer, and fetched by
+								 * mysql_convert_truncated_to_pg() */
+
+	/*
+	 * Conversion plan for the column, resolved once by mysql_bind_result() so
+	 * that fetching a row needs no catalog access.
+	 */
+	Oid			pgtype;			/* local type of the column */
+	int32		typmod;			/* typmod the value is coerced to */
+	Oid			typioparam;		/* type's input function parameter */
+	FmgrInfo	typinput;		/* type's input function */
+	MYSQL_FIELD *field;			/* remote field description */
+	Datum		(*convert) (struct mysql_column *column, char *data);	/* converter */
 }			mysql_column;
 
 typedef struct mysql_table
@@ -276,6 +483,45 @@ typedef struct
 	bool	   *nulls;
 }			MySQLWRState;
 
+/*
+ * What a backend waits for on a MySQL connection, shown by
+ * mysql_fdw_wait_events
+ */
+typedef enum MySQLWaitEvent
+{
+	MYSQL_WAIT_EVENT_CONNECT,	/* connecting to the server */
+	MYSQL_WAIT_EVENT_PREPARE,	/* preparing a statement */
+	MYSQL_WAIT_EVENT_EXECUTE,	/* executing a statement or query */
+	MYSQL_WAIT_EVENT_FETCH,		/* reading rows of a result */
+	MYSQL_WAIT_EVENT_COMMIT		/* ending a remote transaction */
+}			MySQLWaitEvent;
+
+/*
+ * Remote work done for a foreign scan or modification, shown by EXPLAIN
+ * ANALYZE.  Times are only measured when EXPLAIN asks for timing.
+ */
+typedef struct MySQLInstrumentation
+{
+	bool		need_timer;		/* measure the times below? */
+	instr_time	execute_time;	/* time executing statements remotely */
+	instr_time	fetch_time;		/* time blocked in mysql_stmt_fetch */
+	instr_time	convert_time;	/* time converting values */
+	int64		rows;			/* rows fetched or modified */
+	int64		bytes;			/* bytes of values fetched */
+	int64		round_trips;	/* requests sent to the server */
+	int64		prepares;		/* statements prepared */
+	int64		executes;		/* statements executed */
+	int64		batches;		/* batches of rows inserted */
+	int64		batch_rows;		/* rows inserted by them */
+	int64		result_rows;	/* rows fetched since the last execution */
+	bool		compressed;		/* is the connection compressed? */
+	int64		bytes_sent_start;	/* server's Bytes_sent when the scan
+									 * began, or -1 if unknown */
+	int64		bytes_received; /* compressed bytes received since, or -1
+								 * if unknown */
+	instr_time	execute_start;	/* start of an asynchronous execution */
+}			MySQLInstrumentation;
+
 /*
  * FDW-specific information for ForeignScanState
  * fdw_state.
@@ -297,6 +543,60 @@ typedef struct MySQLFdwExecState
 	int			p_nums;			/* number of parameters to transmit */
 	FmgrInfo   *p_flinfo;		/* output conversion functions for them */
 	mysql_opt  *mysqlFdwOptions;	/* MySQL FDW options */
+	MySQLScanMode scan_mode;	/* how rows are fetched */
+	MemoryContextCallback conn_cb;	/* gives back the connection of a
+									 * stream scan */
+	bool		rows_pending;	/* has a stream scan's result rows not read
+								 * yet? */
+	bool		cursor_open;	/* has a cursor scan's cursor rows not read
+								 * yet? */
+	MySQLConnState *conn_state; /* state of the connection used */
+	MySQLInstrumentation *instr;	/* remote work for EXPLAIN ANALYZE, or
+									 * NULL */
+
+	/* Remote query statistics of the result being read */
+	Oid			serverid;		/* foreign server the query is sent to */
+	bool		stat_pending;	/* is a result to be counted? */
+	instr_time	stat_start;		/* when its query was executed */
+	int64		stat_rows;		/* rows read from it */
+	int64		stat_bytes;		/* bytes of values read from it */
+
+	/* Range of keys read by a parallel scan */
+	bool		is_parallel;	/* does the query take a range of keys? */
+	MySQLParallelScanState *pscan;	/* shared state, NULL if run serially */
+	int64		range_lo;		/* lowest key of the range */
+	int64		range_hi;		/* highest key of the range */
+	int32		range_nulls;	/* do rows with a NULL key belong to it? */
+	bool		range_done;		/* has a serial run read its range? */
+	bool		range_isnull;	/* NULL indicator for the range params */
+
+	/* Window of keys read at once by a batched parameterized scan */
+	int			rescan_batch_size;	/* keys of a window, 0 if not batched */
+	AttrNumber	rescan_key_attno;	/* attribute number of the key column */
+	Oid			rescan_key_type;	/* type of the key parameter */
+	ExprState  *rescan_key_expr;	/* value of the key for a rescan */
+	MemoryContext rescan_cxt;	/* holds the rows of the window */
+	HTAB	   *rescan_rows;	/* rows of the window by key */
+	int64		rescan_lo;		/* lowest key of the window */
+	int64		rescan_hi;		/* highest key of the window */
+	Size		rescan_bytes;	/* memory used for the rows of the window */
+	int64		rescan_windows; /* windows read so far */
+	int64		rescan_hits;	/* rescans answered from them */
+	bool		rescan_unbatched;	/* does each rescan read its own key? */
+	bool		rescan_started; /* has this rescan looked up its rows? */
+	List	   *rescan_list;	/* rows of this rescan, from the window or
+								 * the cache below */
+	int			rescan_next;	/* index of the next of them to return */
+	bool		rescan_isnull;	/* NULL indicator for the window params */
+
+	/* Rows of earlier rescans, kept by the values of their parameters */
+	MemoryContext rescan_cache_cxt; /* holds them, NULL if not cached */
+	HTAB	   *rescan_cache;	/* complete results by parameter values */
+	Size		rescan_cache_bytes; /* memory used for them */
+	bool		rescan_cache_hit;	/* is this rescan replaying a result? */
+	bool		rescan_cache_fill;	/* is this rescan collecting its result? */
+	char	   *rescan_cache_key;	/* parameter values of this rescan */
+	int			rescan_cache_keylen;	/* length of rescan_cache_key */
 
 	bool		is_tlist_pushdown;	/* pushdown target list or not */
 	/* working memory context */
@@ -327,6 +627,16 @@ typedef struct MySQLFdwExecState
 	/* Array for holding column values. */
 	Datum	   *wr_values;
 	bool	   *wr_nulls;
+
+	/* Rows fetched in a batch, whose values are converted a column at a time */
+	int			fetch_batch;	/* rows fetched in a batch */
+	mysql_table *fetch_tables;	/* buffers of each of them, or table if
+								 * rows are fetched one at a time */
+	int			fetched_rows;	/* rows of the current batch */
+	int			fetch_next;		/* next of them to return */
+	Datum	   *fetch_values;	/* their values, natts per row */
+	bool	   *fetch_nulls;	/* their NULL flags */
+	bool	   *fetch_converted;	/* values converted when fetched */
 #if PG_VERSION_NUM >= 140000
 	char	   *orig_query;		/* original text of INSERT command */
 	List	   *target_attrs;	/* list of target attribute numbers */
@@ -360,6 +670,9 @@ typedef struct MySQLFdwDirectModifyState
 	List	   *param_exprs;	/* executable expressions for param values */
 	const char **param_values;	/* textual values of query parameters */
 	Oid		   *param_types;	/* type of query parameters */
+	MySQLInstrumentation *instr;	/* remote work for EXPLAIN ANALYZE, or
+									 * NULL */
+	Oid			serverid;		/* foreign server, for the statistics */
 
 	/* for storing result tuples */
 	mysql_table *table;			/* result for query */
@@ -396,19 +709,23 @@ extern int	((mysql_stmt_prepare) (MYSQL_STMT * stmt, const char *query,
 								   unsigned long length));
 extern int	((mysql_stmt_execute) (MYSQL_STMT * stmt));
 extern int	((mysql_stmt_fetch) (MYSQL_STMT * stmt));
+extern int	((mysql_stmt_fetch_column) (MYSQL_STMT * stmt, MYSQL_BIND * bind_arg,
+										unsigned int column,
+										unsigned long offset));
 extern int	((mysql_query) (MYSQL * mysql, const char *q));
 extern bool ((mysql_stmt_attr_set) (MYSQL_STMT * stmt,
 									enum enum_stmt_attr_type attr_type,
 									const void *attr));
 extern bool ((mysql_stmt_close) (MYSQL_STMT * stmt));
 extern bool ((mysql_stmt_reset) (MYSQL_STMT * stmt));
+extern bool ((mysql_stmt_free_result) (MYSQL_STMT * stmt));
 extern bool ((mysql_free_result) (MYSQL_RES * result));
 extern bool ((mysql_stmt_bind_param) (MYSQL_STMT * stmt, MYSQL_BIND * bnd));
 extern bool ((mysql_stmt_bind_result) (MYSQL_STMT * stmt, MYSQL_BIND * bnd));
 
 extern MYSQL_STMT * ((mysql_stmt_init) (MYSQL * mysql));
 extern MYSQL_RES * ((mysql_stmt_result_metadata) (MYSQL_STMT * stmt));
-extern int	((mysql_stmt_store_result) (MYSQL * mysql));
+extern int	((mysql_stmt_store_result) (MYSQL_STMT * stmt));
 extern MYSQL_ROW((mysql_fetch_row) (MYSQL_RES * result));
 extern MYSQL_FIELD * ((mysql_fetch_field) (MYSQL_RES * result));
 extern MYSQL_FIELD * ((mysql_fetch_fields) (MYSQL_RES * result));
@@ -435,6 +752,27 @@ extern unsigned int ((mysql_num_fields) (MYSQL_RES * result));
 extern unsigned int ((mysql_num_rows) (MYSQL_RES * result));
 extern unsigned int ((mysql_warning_count) (MYSQL * mysql));
 extern uint64_t ((mysql_stmt_affected_rows) (MYSQL_STMT * stmt));
+extern unsigned long ((mysql_thread_id) (MYSQL * mysql));
+extern int	((mysql_ping) (MYSQL * mysql));
+#ifdef MYSQL_FDW_ASYNC
+extern int	((mysql_stmt_execute_start) (int *ret, MYSQL_STMT * stmt));
+extern int	((mysql_stmt_execute_cont) (int *ret, MYSQL_STMT * stmt,
+										int ready_status));
+extern my_socket ((mysql_get_socket) (MYSQL * mysql));
+extern unsigned int ((mysql_get_timeout_value_ms) (const MYSQL * mysql));
+extern int	((mysql_real_query_start) (int *ret, MYSQL * mysql,
+										const char *query,
+										unsigned long length));
+extern int	((mysql_real_query_cont) (int *ret, MYSQL * mysql,
+									   int ready_status));
+
+extern bool mysql_async_supported;
+extern void mysql_finish_async_execute(MySQLConnState *state,
+									   bool interruptible);
+extern uint32 mysql_async_wait_events(MYSQL * conn, int status,
+									  long *timeout);
+extern int	mysql_async_ready_status(int status, int occurred);
+#endif
 
 void		mysql_reset_transmission_modes(int nestlevel);
 int			mysql_set_transmission_modes(void);
@@ -442,6 +780,12 @@ int			mysql_set_transmission_modes(void);
 /* option.c headers */
 extern bool mysql_is_valid_option(const char *option, Oid context);
 extern mysql_opt * mysql_get_options(Oid foreigntableid, bool is_foreigntable);
+extern MySQLScanMode mysql_parse_scan_mode(DefElem *def);
+extern MySQLTransactionMode mysql_parse_transaction_mode(DefElem *def);
+extern MySQLCompression mysql_parse_compression(DefElem *def);
+extern MySQLTransport mysql_parse_transport(DefElem *def);
+extern List *mysql_parse_replicas(DefElem *def);
+extern MySQLReplicaSelection mysql_parse_replica_selection(DefElem *def);
 
 /* depare.c headers */
 extern void mysql_deparse_select(StringInfo buf, PlannerInfo *root,
@@ -485,6 +829,16 @@ extern void mysql_append_where_clause(StringInfo buf, PlannerInfo *root,
 									  RelOptInfo *baserel, List *exprs,
 									  bool is_first, List **params);
 extern void mysql_deparse_analyze(StringInfo buf, char *dbname, char *relname);
+extern void mysql_append_parallel_range_clause(StringInfo buf,
+											   PlannerInfo *root,
+											   RelOptInfo *baserel,
+											   bool is_first);
+extern void mysql_append_rescan_batch_clause(StringInfo buf,
+											 PlannerInfo *root,
+											 RelOptInfo *baserel,
+											 AttrNumber attnum,
+											 bool is_first);
+extern void mysql_deparse_key_range(StringInfo buf, Relation rel);
 #if PG_VERSION_NUM >= 140000
 extern void mysql_deparse_truncate_sql(StringInfo buf,
 									   List *rels);
@@ -517,11 +871,36 @@ extern List *mysql_pull_func_clause(Node *node);
 
 /* connection.c headers */
 MYSQL	   *mysql_get_connection(ForeignServer *server, UserMapping *user,
-								 mysql_opt * opt);
+								 mysql_opt * opt, bool read_only);
+MYSQL	   *mysql_get_private_connection(ForeignServer *server,
+										 UserMapping *user, mysql_opt * opt,
+										 bool read_only);
+void		mysql_release_private_connection(MYSQL * conn, bool discard);
+extern bool mysql_xact_wrote(ForeignServer *server, UserMapping *user);
 MYSQL	   *mysql_connect(mysql_opt * opt);
 void		mysql_cleanup_connection(void);
 void		mysql_release_connection(MYSQL * conn);
+extern MySQLConnState *mysql_get_conn_state(MYSQL * conn);
+extern void mysql_check_conn_state(MYSQL * conn, MySQLConnState *state);
+extern int	mysql_run_query(MYSQL * conn, const char *query);
+extern int	mysql_run_query_wait(MYSQL * conn, const char *query,
+								 MySQLWaitEvent wait_event);
+extern MYSQL_STMT *mysql_stmt_cache_lookup(MYSQL * conn, const char *query);
+extern void mysql_stmt_cache_insert(MYSQL * conn, const char *query,
+									MYSQL_STMT * stmt);
+extern void mysql_stmt_cache_release(MYSQL * conn, MYSQL_STMT * stmt,
+									 bool reset);
 extern char *mysql_quote_identifier(const char *str, char quotechar);
+extern char *mysql_get_column_name(Oid relid, int attnum);
+
+/* mysql_stat.c headers */
+extern void mysql_stat_init(void);
+extern uint32 mysql_wait_event(MySQLWaitEvent event);
+extern bool mysql_stat_enabled(void);
+extern void mysql_stat_record(Oid serverid, const char *query,
+							  double total_time, int64 rows, int64 bytes);
+extern int	mysql_replica_acquire(Oid serverid, int nreplicas);
+extern void mysql_replica_release(Oid serverid, int replica);
 
 #if PG_VERSION_NUM < 110000		/* TupleDescAttr is defined from PG version 11 */
 #define TupleDescAttr(tupdesc, i) ((tupdesc)->attrs[(i)])
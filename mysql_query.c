@@ -19,6 +19,7 @@
  */
 #include "mysql_fdw.h"
 
+#include <math.h>
 #include <mysql.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -26,6 +27,8 @@
 
 #include "access/htup_details.h"
 #include "catalog/pg_type.h"
+#include "mb/pg_wchar.h"
+#include "miscadmin.h"
 #include "mysql_query.h"
 #if PG_VERSION_NUM < 120000
 #include "optimizer/var.h"
@@ -36,6 +39,7 @@
 #include "utils/date.h"
 #include "utils/datetime.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/syscache.h"
 
 #define DATE_MYSQL_PG(x, y) \
@@ -48,103 +52,200 @@ x->minute = y.tm_min; \
 x->second = y.tm_sec; \
 } while(0);
 
+#if PG_VERSION_NUM < 130000
+/* Not exported by the core code before 13; go through the typmod coercions */
+#define AdjustTimestampForTypmod(time, typmod) \
+	(*(time) = DatumGetTimestamp(DirectFunctionCall2(timestamp_scale, \
+													  TimestampGetDatum(*(time)), \
+													  Int32GetDatum(typmod))))
+#define AdjustTimeForTypmod(time, typmod) \
+	(*(time) = DatumGetTimeADT(DirectFunctionCall2(time_scale, \
+													TimeADTGetDatum(*(time)), \
+													Int32GetDatum(typmod))))
+#endif
+
 static int32 mysql_from_pgtyp(Oid type);
 static char *dec_bin(unsigned long number, int sz);
 static int	bin_dec(int binarynumber);
+static unsigned long mysql_bind_buffer_length(MYSQL_FIELD * field);
+static bool mysql_is_integer_field(MYSQL_FIELD * field);
+static bool mysql_is_lob_field(MYSQL_FIELD * field);
+static Datum mysql_convert_text(mysql_column * column, char *data);
+static Datum mysql_convert_varlena(mysql_column * column, char *data);
+static Datum mysql_convert_bytea(mysql_column * column, char *data);
+static Datum mysql_convert_bit(mysql_column * column, char *data);
+static Datum mysql_convert_native(mysql_column * column, char *data);
 
 /*
- * convert_mysql_to_pg:
- * 		Convert MySQL data into PostgreSQL's compatible data types
+ * mysql_convert_to_pg:
+ * 		Convert MySQL data into PostgreSQL's compatible data types, using the
+ * 		converter chosen by mysql_bind_result()
  */
 Datum
-mysql_convert_to_pg(Oid pgtyp, int pgtypmod, mysql_column * column, MYSQL_FIELD field)
+mysql_convert_to_pg(mysql_column * column)
 {
-	Datum		value_datum;
-	Datum		valueDatum;
-	regproc		typeinput;
-	HeapTuple	tuple;
-	int			typemod;
-	char	   *str = palloc0(MAXDATELEN);
-	bytea	   *result;
-
-	/* get the type's output function */
-	tuple = SearchSysCache1(TYPEOID, ObjectIdGetDatum(pgtyp));
-	if (!HeapTupleIsValid(tuple))
-		elog(ERROR, "cache lookup failed for type%u", pgtyp);
+	return column->convert(column, column->mysql_bind->buffer);
+}
 
-	typeinput = ((Form_pg_type) GETSTRUCT(tuple))->typinput;
-	typemod = ((Form_pg_type) GETSTRUCT(tuple))->typtypmod;
-	ReleaseSysCache(tuple);
+/*
+ * mysql_convert_truncated_to_pg:
+ * 		Convert a value that did not fit in the bind buffer sized by
+ * 		mysql_bind_result(), or of a TEXT or BLOB column bound without one
+ *
+ * column->length holds the actual length of the value, so fetch it again,
+ * piece by piece, into a buffer of that size laid out like the bind buffers
+ * of mysql_bind_result(), which the converters expect.
+ */
+Datum
+mysql_convert_truncated_to_pg(MYSQL_STMT * stmt, unsigned int colno,
+							  mysql_column * column)
+{
+	MYSQL_BIND	mbind;
+	unsigned long length;
+	unsigned long offset;
+	bool		is_null;
+	bool		error;
+	char	   *data;
+
+	if (column->length > MaxAllocSize - VARHDRSZ - 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+				 errmsg("value of MySQL column %u is too large", colno),
+				 errdetail("The value is %lu bytes long.", column->length)));
+
+	data = (char *) palloc(VARHDRSZ + column->length + 1) + VARHDRSZ;
+
+	mbind = *column->mysql_bind;
+#if MYSQL_VERSION_ID < 80000 || MARIADB_VERSION_ID >= 100000
+	mbind.is_null = (my_bool *) & is_null;
+	mbind.error = (my_bool *) & error;
+#else
+	mbind.is_null = &is_null;
+	mbind.error = &error;
+#endif
+	mbind.length = &length;
 
-	switch (pgtyp)
+	for (offset = 0; offset < column->length; offset += mbind.buffer_length)
 	{
-			/* -----
-			 * MySQL gives BIT / BIT(n) data type as decimal value.  The only
-			 * way to retrieve this value is to use BIN, OCT or HEX function
-			 * in MySQL, otherwise mysql client shows the actual decimal
-			 * value, which could be a non - printable character.  For exmple
-			 * in MySQL
-			 *
-			 * CREATE TABLE t (b BIT(8)); INSERT INTO t SET b = b'1001';
-			 * SELECT BIN(b) FROM t; +--------+ | BIN(b) | +--------+ | 1001 |
-			 * +--------+
-			 *
-			 * PostgreSQL expacts all binary data to be composed of either '0'
-			 * or '1'. MySQL gives value 9 hence PostgreSQL reports error. The
-			 * solution is to convert the decimal number into equivalent
-			 * binary string.
-			 * -----
-			 */
-		case BYTEAOID:
-			result = (bytea *) palloc(column->length + VARHDRSZ);
-			memcpy(VARDATA(result), VARDATA(column->value), column->length);
-			SET_VARSIZE(result, column->length + VARHDRSZ);
-			return PointerGetDatum(result);
+		mbind.buffer = data + offset;
+		mbind.buffer_length = Min(column->length - offset,
+								  MYSQL_LOB_CHUNK_SIZE);
 
-		case BITOID:
-			{
-				/*
-				 * For bit type, need to convert each character to binary 8
-				 * bit.
-				 */
-				char	   *outputString = (char *) column->value;
-				int			i;
-
-				if (field.type == MYSQL_TYPE_BIT)
-				{
-					for (i = 0; i < strlen(outputString); i++)
-					{
-						unsigned long v = (unsigned long) outputString[i];
+		if (mysql_stmt_fetch_column(stmt, &mbind, colno, offset) != 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
+					 errmsg("failed to fetch truncated value of MySQL column %u",
+							colno)));
 
-						sprintf(str, "%s%s", str, dec_bin(v, 8));
-					}
-				}
-				else
-				{
-					unsigned long value = atoll(outputString);
+		CHECK_FOR_INTERRUPTS();
+	}
 
-					sprintf(str, "%s", dec_bin(value, 64));
-				}
+	data[column->length] = '\0';
+
+	return column->convert(column, data);
+}
+
+/*
+ * mysql_convert_text:
+ * 		Convert a value fetched as text using the type's input function
+ */
+static Datum
+mysql_convert_text(mysql_column * column, char *data)
+{
+	return InputFunctionCall(&column->typinput, data, column->typioparam,
+							 column->typmod);
+}
+
+/*
+ * mysql_convert_varlena:
+ * 		Convert a value fetched as text into text, varchar or bpchar
+ *
+ * The value is left where it was fetched, and the varlena header stamped in
+ * the room left for it before the data, so it is only valid until the next
+ * row is fetched.  Like the input function called without a typmod, this
+ * neither pads nor checks the value against the length of the local column.
+ * A value holding a NUL byte still goes through the input function, which
+ * cuts it short as it always did.
+ */
+static Datum
+mysql_convert_varlena(mysql_column * column, char *data)
+{
+	struct varlena *result = (struct varlena *) (data - VARHDRSZ);
 
-				/* Remove leading zero */
-				while (str[0] == '0')
-					str++;
+	if (memchr(data, '\0', column->length) != NULL)
+		return InputFunctionCall(&column->typinput, data, column->typioparam,
+								 column->typmod);
 
-				if (strcmp(str, "") == 0)
-					str[0] = '0';
+	SET_VARSIZE(result, column->length + VARHDRSZ);
 
-				valueDatum = CStringGetDatum((char *) str);
-				break;
-			}
-		default:
-			valueDatum = CStringGetDatum((char *) column->value);
+	return PointerGetDatum(result);
+}
+
+/*
+ * mysql_convert_bytea:
+ * 		Convert a value fetched as MYSQL_TYPE_BLOB into bytea
+ *
+ * Like mysql_convert_varlena(), the value is returned where it was fetched.
+ */
+static Datum
+mysql_convert_bytea(mysql_column * column, char *data)
+{
+	bytea	   *result = (bytea *) (data - VARHDRSZ);
+
+	SET_VARSIZE(result, column->length + VARHDRSZ);
+
+	return PointerGetDatum(result);
+}
+
+/*
+ * mysql_convert_bit:
+ * 		Convert a value fetched as text into bit
+ *
+ * MySQL gives BIT / BIT(n) data type as decimal value.  The only way to
+ * retrieve this value is to use BIN, OCT or HEX function in MySQL, otherwise
+ * mysql client shows the actual decimal value, which could be a non -
+ * printable character.  For exmple in MySQL
+ *
+ * CREATE TABLE t (b BIT(8)); INSERT INTO t SET b = b'1001';
+ * SELECT BIN(b) FROM t; +--------+ | BIN(b) | +--------+ | 1001 | +--------+
+ *
+ * PostgreSQL expacts all binary data to be composed of either '0' or '1'.
+ * MySQL gives value 9 hence PostgreSQL reports error.  The solution is to
+ * convert the decimal number into equivalent binary string.
+ */
+static Datum
+mysql_convert_bit(mysql_column * column, char *data)
+{
+	char	   *str = palloc0(MAXDATELEN);
+	char	   *outputString = data;
+	int			i;
+
+	/* For bit type, need to convert each character to binary 8 bit. */
+	if (column->field->type == MYSQL_TYPE_BIT)
+	{
+		for (i = 0; i < strlen(outputString); i++)
+		{
+			unsigned long v = (unsigned long) outputString[i];
+
+			sprintf(str, "%s%s", str, dec_bin(v, 8));
+		}
+	}
+	else
+	{
+		unsigned long value = atoll(outputString);
+
+		sprintf(str, "%s", dec_bin(value, 64));
 	}
 
-	value_datum = OidFunctionCall3(typeinput, valueDatum,
-								   ObjectIdGetDatum(pgtyp),
-								   Int32GetDatum(typemod));
+	/* Remove leading zero */
+	while (str[0] == '0')
+		str++;
+
+	if (strcmp(str, "") == 0)
+		str[0] = '0';
 
-	return value_datum;
+	return InputFunctionCall(&column->typinput, str, column->typioparam,
+							 column->typmod);
 }
 
 /*
@@ -442,6 +543,8 @@ mysql_bind_result(Oid pgtyp, int pgtypmod, MYSQL_FIELD * field,
 				  mysql_column * column)
 {
 	MYSQL_BIND *mbind = column->mysql_bind;
+	HeapTuple	tuple;
+	unsigned long buffer_length;
 
 #if MYSQL_VERSION_ID < 80000 || MARIADB_VERSION_ID >= 100000
 	mbind->is_null = (my_bool *) & column->is_null;
@@ -452,21 +555,365 @@ mysql_bind_result(Oid pgtyp, int pgtypmod, MYSQL_FIELD * field,
 #endif
 	mbind->length = &column->length;
 
+	column->pgtype = pgtyp;
+	column->field = field;
+
 	switch (pgtyp)
 	{
 		case BYTEAOID:
 			mbind->buffer_type = MYSQL_TYPE_BLOB;
+			column->convert = mysql_convert_bytea;
+
+			/*
+			 * BLOB values are fetched straight into the bytea built for them,
+			 * so they need no buffer here.
+			 */
+			if (mysql_is_lob_field(field))
+			{
+				column->is_lob = true;
+				return;
+			}
+
 			/* Leave room at front for bytea buffer length prefix */
-			column->value = (Datum) palloc0(MAX_BLOB_WIDTH + VARHDRSZ);
+			buffer_length = mysql_bind_buffer_length(field);
+			column->value = (Datum) palloc0(buffer_length + VARHDRSZ);
 			mbind->buffer = VARDATA(column->value);
-			mbind->buffer_length = MAX_BLOB_WIDTH;
+			mbind->buffer_length = buffer_length;
+			return;
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case BOOLOID:
+			/* Fetch integers as a 64-bit value and range check them later */
+			if (mysql_is_integer_field(field))
+			{
+				mbind->buffer_type = MYSQL_TYPE_LONGLONG;
+				mbind->is_unsigned = (field->flags & UNSIGNED_FLAG) != 0;
+				column->value = (Datum) palloc0(sizeof(int64));
+				mbind->buffer = (char *) column->value;
+				mbind->buffer_length = sizeof(int64);
+				column->convert = mysql_convert_native;
+				return;
+			}
+			break;
+		case FLOAT4OID:
+		case FLOAT8OID:
+
+			/*
+			 * A single-precision MySQL FLOAT widened to double would not give
+			 * the same float8 value as parsing its text representation, so
+			 * only float4 accepts it natively.
+			 */
+			if (mysql_is_integer_field(field) ||
+				field->type == MYSQL_TYPE_DOUBLE ||
+				(field->type == MYSQL_TYPE_FLOAT && pgtyp == FLOAT4OID))
+			{
+				mbind->buffer_type = MYSQL_TYPE_DOUBLE;
+				column->value = (Datum) palloc0(sizeof(double));
+				mbind->buffer = (char *) column->value;
+				mbind->buffer_length = sizeof(double);
+				column->convert = mysql_convert_native;
+				return;
+			}
+			break;
+		case DATEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			if (field->type == MYSQL_TYPE_DATE ||
+				field->type == MYSQL_TYPE_NEWDATE ||
+				field->type == MYSQL_TYPE_DATETIME ||
+				field->type == MYSQL_TYPE_TIMESTAMP)
+			{
+				mbind->buffer_type = MYSQL_TYPE_DATETIME;
+				column->value = (Datum) palloc0(sizeof(MYSQL_TIME));
+				mbind->buffer = (char *) column->value;
+				mbind->buffer_length = sizeof(MYSQL_TIME);
+				column->typmod = pgtypmod;
+				column->convert = mysql_convert_native;
+				return;
+			}
+			break;
+		case TIMEOID:
+			if (field->type == MYSQL_TYPE_TIME)
+			{
+				mbind->buffer_type = MYSQL_TYPE_TIME;
+				column->value = (Datum) palloc0(sizeof(MYSQL_TIME));
+				mbind->buffer = (char *) column->value;
+				mbind->buffer_length = sizeof(MYSQL_TIME);
+				column->typmod = pgtypmod;
+				column->convert = mysql_convert_native;
+				return;
+			}
+			break;
+		default:
+			break;
+	}
+
+	/*
+	 * Everything else, including remote types that do not map cleanly on
+	 * the local column type, is fetched as text and parsed by the type's
+	 * input function.
+	 */
+	mbind->buffer_type = MYSQL_TYPE_VAR_STRING;
+
+	/*
+	 * TEXT values are fetched into a string of their own size, so they need
+	 * no buffer here.  Others get one sized from the metadata, with room at
+	 * front for a varlena header.  Its extra byte is never written by the
+	 * client library, so the value is terminated even when it fills the
+	 * whole buffer.
+	 */
+	if (mysql_is_lob_field(field))
+		column->is_lob = true;
+	else
+	{
+		buffer_length = mysql_bind_buffer_length(field);
+		column->value = (Datum) palloc0(VARHDRSZ + buffer_length + 1);
+		mbind->buffer = VARDATA(column->value);
+		mbind->buffer_length = buffer_length;
+	}
+
+	/* Look up the type's input function once for the whole scan */
+	tuple = SearchSysCache1(TYPEOID, ObjectIdGetDatum(pgtyp));
+	if (!HeapTupleIsValid(tuple))
+		elog(ERROR, "cache lookup failed for type%u", pgtyp);
+
+	fmgr_info(((Form_pg_type) GETSTRUCT(tuple))->typinput, &column->typinput);
+	column->typioparam = getTypeIOParam(tuple);
+	column->typmod = ((Form_pg_type) GETSTRUCT(tuple))->typtypmod;
+	ReleaseSysCache(tuple);
+
+	switch (pgtyp)
+	{
+		case BITOID:
+			column->convert = mysql_convert_bit;
+			break;
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+			/* Text-like values are taken as is */
+			column->convert = mysql_convert_varlena;
+			break;
+		default:
+			column->convert = mysql_convert_text;
+			break;
+	}
+}
+
+/*
+ * mysql_bind_buffer_length:
+ * 		Size of the buffer to fetch a text or blob column into
+ *
+ * field->length is the maximum length of the column's values as given by the
+ * result set metadata.  Buffers are capped at MAXDATALEN; longer values come
+ * back as MYSQL_DATA_TRUNCATED and are fetched again by
+ * mysql_convert_truncated_to_pg().
+ */
+static unsigned long
+mysql_bind_buffer_length(MYSQL_FIELD * field)
+{
+	return Min(Max(field->length, 1), MAXDATALEN);
+}
+
+/*
+ * mysql_is_lob_field:
+ * 		True if the field is a TEXT or BLOB column, whose values may be far
+ * 		larger than the usual ones.
+ */
+static bool
+mysql_is_lob_field(MYSQL_FIELD * field)
+{
+	switch (field->type)
+	{
+		case MYSQL_TYPE_BLOB:
+		case MYSQL_TYPE_MEDIUM_BLOB:
+		case MYSQL_TYPE_LONG_BLOB:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * mysql_is_integer_field:
+ * 		True if MySQL sends the field as an integer in the binary protocol.
+ */
+static bool
+mysql_is_integer_field(MYSQL_FIELD * field)
+{
+	switch (field->type)
+	{
+		case MYSQL_TYPE_TINY:
+		case MYSQL_TYPE_SHORT:
+		case MYSQL_TYPE_INT24:
+		case MYSQL_TYPE_LONG:
+		case MYSQL_TYPE_LONGLONG:
+		case MYSQL_TYPE_YEAR:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * mysql_convert_native:
+ * 		Build a Datum from a column that was bound to a native integer,
+ * 		double or MYSQL_TIME buffer by mysql_bind_result().
+ *
+ * The checks mirror the ones done by the input functions, so that a value
+ * rejected by the text path is rejected here as well, and time and timestamp
+ * values are rounded to the precision of the column like they do.
+ */
+static Datum
+mysql_convert_native(mysql_column * column, char *data)
+{
+	MYSQL_BIND *mbind = column->mysql_bind;
+	Oid			pgtyp = column->pgtype;
+
+	switch (mbind->buffer_type)
+	{
+		case MYSQL_TYPE_LONGLONG:
+			{
+				int64		value = *(int64 *) data;
+				char		buf[MAXINT8LEN + 1];
+
+				if (mbind->is_unsigned && value < 0)
+				{
+					snprintf(buf, sizeof(buf), UINT64_FORMAT, (uint64) value);
+					ereport(ERROR,
+							(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+							 errmsg("value \"%s\" is out of range for type %s",
+									buf, format_type_be(pgtyp))));
+				}
+
+				switch (pgtyp)
+				{
+					case INT2OID:
+						if (value < PG_INT16_MIN || value > PG_INT16_MAX)
+							break;
+						return Int16GetDatum((int16) value);
+					case INT4OID:
+						if (value < PG_INT32_MIN || value > PG_INT32_MAX)
+							break;
+						return Int32GetDatum((int32) value);
+					case INT8OID:
+						return Int64GetDatum(value);
+					case BOOLOID:
+						if (value != 0 && value != 1)
+						{
+							snprintf(buf, sizeof(buf), INT64_FORMAT, value);
+							ereport(ERROR,
+									(errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+									 errmsg("invalid input syntax for type %s: \"%s\"",
+											"boolean", buf)));
+						}
+						return BoolGetDatum(value == 1);
+					default:
+						elog(ERROR, "unexpected type %u for integer column",
+							 pgtyp);
+				}
+
+				snprintf(buf, sizeof(buf), INT64_FORMAT, value);
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("value \"%s\" is out of range for type %s",
+								buf, format_type_be(pgtyp))));
+			}
+			break;
+		case MYSQL_TYPE_DOUBLE:
+			{
+				double		value = *(double *) data;
+
+				if (pgtyp == FLOAT8OID)
+					return Float8GetDatum(value);
+
+				if ((isinf((float) value) && !isinf(value)) ||
+					((float) value == 0.0f && value != 0.0))
+					ereport(ERROR,
+							(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+							 errmsg("\"%g\" is out of range for type real",
+									value)));
+				return Float4GetDatum((float4) value);
+			}
+			break;
+		case MYSQL_TYPE_DATETIME:
+		case MYSQL_TYPE_TIME:
+			{
+				MYSQL_TIME *mt = (MYSQL_TIME *) data;
+				struct pg_tm tt,
+						   *tm = &tt;
+				fsec_t		fsec = mt->second_part;
+
+				memset(tm, 0, sizeof(struct pg_tm));
+				tm->tm_year = mt->year;
+				tm->tm_mon = mt->month;
+				tm->tm_mday = mt->day;
+				tm->tm_hour = mt->hour;
+				tm->tm_min = mt->minute;
+				tm->tm_sec = mt->second;
+
+				if (pgtyp == TIMEOID)
+				{
+					TimeADT		result;
+
+					if (mt->neg || tm->tm_hour > HOURS_PER_DAY ||
+						(tm->tm_hour == HOURS_PER_DAY &&
+						 (tm->tm_min > 0 || tm->tm_sec > 0 || fsec > 0)))
+						ereport(ERROR,
+								(errcode(ERRCODE_DATETIME_FIELD_OVERFLOW),
+								 errmsg("date/time field value out of range: \"%s%02u:%02u:%02u\"",
+										mt->neg ? "-" : "", mt->hour,
+										mt->minute, mt->second)));
+
+					tm2time(tm, fsec, &result);
+					AdjustTimeForTypmod(&result, column->typmod);
+					return TimeADTGetDatum(result);
+				}
+
+				/* MySQL permits zero dates, PostgreSQL does not */
+				if (tm->tm_year < 1 || tm->tm_mon < 1 ||
+					tm->tm_mon > MONTHS_PER_YEAR || tm->tm_mday < 1 ||
+					tm->tm_mday > day_tab[isleap(tm->tm_year)][tm->tm_mon - 1])
+					ereport(ERROR,
+							(errcode(ERRCODE_DATETIME_FIELD_OVERFLOW),
+							 errmsg("date/time field value out of range: \"%04u-%02u-%02u\"",
+									mt->year, mt->month, mt->day)));
+
+				if (pgtyp == DATEOID)
+					return DateADTGetDatum(date2j(tm->tm_year, tm->tm_mon,
+												  tm->tm_mday) -
+										   POSTGRES_EPOCH_JDATE);
+				else
+				{
+					Timestamp	result;
+					int			tz;
+
+					if (pgtyp == TIMESTAMPTZOID)
+					{
+						tz = DetermineTimeZoneOffset(tm, session_timezone);
+						if (tm2timestamp(tm, fsec, &tz, &result) != 0)
+							ereport(ERROR,
+									(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+									 errmsg("timestamp out of range")));
+						AdjustTimestampForTypmod(&result, column->typmod);
+						return TimestampTzGetDatum(result);
+					}
+
+					if (tm2timestamp(tm, fsec, NULL, &result) != 0)
+						ereport(ERROR,
+								(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+								 errmsg("timestamp out of range")));
+					AdjustTimestampForTypmod(&result, column->typmod);
+					return TimestampGetDatum(result);
+				}
+			}
 			break;
 		default:
-			mbind->buffer_type = MYSQL_TYPE_VAR_STRING;
-			column->value = (Datum) palloc0(MAXDATALEN);
-			mbind->buffer = (char *) column->value;
-			mbind->buffer_length = MAXDATALEN;
+			elog(ERROR, "unexpected MySQL buffer type %d",
+				 (int) mbind->buffer_type);
 	}
+
+	return (Datum) 0;			/* keep compiler quiet */
 }
 
 static char *
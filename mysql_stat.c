@@ -0,0 +1,784 @@
+/*-------------------------------------------------------------------------
+ *
+ * mysql_stat.c
+ * 		Statistics of the queries sent to remote MySQL servers
+ *
+ * Portions Copyright (c) 2012-2014, PostgreSQL Global Development Group
+ * Portions Copyright (c) 2004-2021, EnterpriseDB Corporation.
+ *
+ * The statistics are kept in a fixed-size hash table in shared memory, keyed
+ * by database, foreign server and remote SQL text, so they are only
+ * available when mysql_fdw is loaded via shared_preload_libraries.  Once the
+ * table is full, the entries called the least often are dropped in a batch
+ * to make room for new ones, as pg_stat_statements does.
+ *
+ * The same shared memory counts, for each read replica of a foreign server,
+ * the transactions of all sessions currently reading from it, for the
+ * least_outstanding replica_selection.  It also keeps, for each backend, what
+ * it last waited for on a MySQL connection, shown by mysql_fdw_wait_events.
+ *
+ * IDENTIFICATION
+ * 		mysql_stat.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+/*
+ * Must be included before mysql.h as it has some conflicting definitions like
+ * list_length, etc.
+ */
+#include "mysql_fdw.h"
+
+#include <mysql.h>
+
+#if PG_VERSION_NUM >= 130000
+#include "common/hashfn.h"
+#else
+#include "access/hash.h"
+#endif
+#include "foreign/foreign.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "postmaster/autovacuum.h"
+#include "replication/walsender.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/procarray.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/tuplestore.h"
+
+/* Longest remote SQL text kept; longer texts are truncated */
+#define MYSQL_STAT_QUERY_LEN	1024
+
+/* Share of the entries dropped when the hash table is full, and least count */
+#define MYSQL_STAT_DEALLOC_PERCENT	5
+#define MYSQL_STAT_DEALLOC_MIN		10
+
+#define MYSQL_FDW_STAT_STATEMENTS_COLS	10
+#define MYSQL_FDW_WAIT_EVENTS_COLS		2
+
+/* Most read replicas whose load is counted at once */
+#define MYSQL_MAX_REPLICA_LOADS	1024
+
+/* Hash key of the statistics of a remote query */
+typedef struct MySQLStatKey
+{
+	Oid			dbid;			/* database the query was sent from */
+	Oid			serverid;		/* foreign server it was sent to */
+	uint64		queryid;		/* hash of its text */
+} MySQLStatKey;
+
+/* Statistics of a remote query */
+typedef struct MySQLStatEntry
+{
+	MySQLStatKey key;			/* hash key (must be first) */
+	slock_t		mutex;			/* protects the counters below */
+	int64		calls;			/* times the query was sent */
+	double		total_time;		/* total time spent on it, in ms */
+	double		min_time;		/* shortest time spent on it, in ms */
+	double		max_time;		/* longest time spent on it, in ms */
+	int64		rows;			/* rows fetched or modified */
+	int64		bytes;			/* bytes of values fetched */
+	char		query[MYSQL_STAT_QUERY_LEN];	/* its text, maybe truncated */
+} MySQLStatEntry;
+
+/* Hash key of the load of a read replica */
+typedef struct MySQLReplicaLoadKey
+{
+	Oid			dbid;			/* database of the foreign server */
+	Oid			serverid;		/* foreign server the replica belongs to */
+	int			replica;		/* index of the replica in its list */
+} MySQLReplicaLoadKey;
+
+/* Load of a read replica, kept only while it is not zero */
+typedef struct MySQLReplicaLoad
+{
+	MySQLReplicaLoadKey key;	/* hash key (must be first) */
+	int			outstanding;	/* transactions reading from the replica */
+} MySQLReplicaLoad;
+
+/* What a backend last waited for on a MySQL connection */
+typedef struct MySQLWaitState
+{
+	int			pid;			/* backend, 0 if it never waited */
+	MySQLWaitEvent event;		/* what it waited for */
+} MySQLWaitState;
+
+/* Shared state of the statistics */
+typedef struct MySQLStatShared
+{
+	LWLock	   *lock;			/* protects the hash table */
+	LWLock	   *replica_lock;	/* protects the replica load hash table */
+} MySQLStatShared;
+
+/* Names of the wait events, by MySQLWaitEvent */
+static const char *const mysql_wait_event_names[] = {
+	"MySQLConnect",
+	"MySQLPrepare",
+	"MySQLExecute",
+	"MySQLFetch",
+	"MySQLCommit"
+};
+
+/* Maximum number of remote queries tracked */
+static int	mysql_stat_max = 1000;
+
+/* Are remote queries tracked? */
+static bool mysql_stat_track = true;
+
+static MySQLStatShared *mysql_stat_shared = NULL;
+static HTAB *mysql_stat_hash = NULL;
+static HTAB *mysql_replica_hash = NULL;
+static MySQLWaitState *mysql_wait_states = NULL;
+
+/* Number of mysql_wait_states, one for each backend */
+static int	mysql_wait_nstates = 0;
+
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+PG_FUNCTION_INFO_V1(mysql_fdw_stat_statements);
+PG_FUNCTION_INFO_V1(mysql_fdw_stat_statements_reset);
+PG_FUNCTION_INFO_V1(mysql_fdw_wait_events);
+
+static Size mysql_stat_memsize(void);
+static void mysql_stat_shmem_startup(void);
+static MySQLStatEntry *mysql_stat_entry_alloc(MySQLStatKey *key,
+											  const char *query);
+static void mysql_stat_entry_dealloc(void);
+static int	mysql_stat_entry_cmp(const void *lhs, const void *rhs);
+
+/*
+ * mysql_stat_init
+ * 		Define the settings of the statistics, and ask for their shared
+ * 		memory when loaded via shared_preload_libraries
+ */
+void
+mysql_stat_init(void)
+{
+	DefineCustomIntVariable("mysql_fdw.stat_max",
+							"Sets the maximum number of remote queries tracked by mysql_fdw_stat_statements.",
+							NULL,
+							&mysql_stat_max,
+							1000,
+							100,
+							INT_MAX / 2,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomBoolVariable("mysql_fdw.stat_track",
+							 "Selects whether remote queries are tracked by mysql_fdw_stat_statements.",
+							 NULL,
+							 &mysql_stat_track,
+							 true,
+							 PGC_SUSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+
+	/*
+	 * MaxBackends is not computed yet, so count the backends the same way
+	 * InitializeMaxBackends() will.
+	 */
+	mysql_wait_nstates = MaxConnections + autovacuum_max_workers + 1 +
+		max_worker_processes;
+#if PG_VERSION_NUM >= 120000
+	mysql_wait_nstates += max_wal_senders;
+#endif
+
+	RequestAddinShmemSpace(mysql_stat_memsize());
+	RequestNamedLWLockTranche("mysql_fdw", 2);
+
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = mysql_stat_shmem_startup;
+}
+
+/*
+ * mysql_stat_memsize
+ * 		Shared memory needed by the statistics
+ */
+static Size
+mysql_stat_memsize(void)
+{
+	Size		size;
+
+	size = add_size(MAXALIGN(sizeof(MySQLStatShared)),
+					hash_estimate_size(mysql_stat_max,
+									   sizeof(MySQLStatEntry)));
+	size = add_size(size, hash_estimate_size(MYSQL_MAX_REPLICA_LOADS,
+											 sizeof(MySQLReplicaLoad)));
+	size = add_size(size, mul_size(mysql_wait_nstates,
+								   sizeof(MySQLWaitState)));
+
+	return size;
+}
+
+/*
+ * mysql_stat_shmem_startup
+ * 		Create the shared hash table of the statistics, or attach to it
+ */
+static void
+mysql_stat_shmem_startup(void)
+{
+	HASHCTL		ctl;
+	bool		found;
+
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+
+	mysql_stat_shared = ShmemInitStruct("mysql_fdw stat_statements",
+										sizeof(MySQLStatShared), &found);
+	if (!found)
+	{
+		LWLockPadded *locks = GetNamedLWLockTranche("mysql_fdw");
+
+		mysql_stat_shared->lock = &locks[0].lock;
+		mysql_stat_shared->replica_lock = &locks[1].lock;
+	}
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(MySQLStatKey);
+	ctl.entrysize = sizeof(MySQLStatEntry);
+	mysql_stat_hash = ShmemInitHash("mysql_fdw stat_statements hash",
+									mysql_stat_max, mysql_stat_max,
+									&ctl, HASH_ELEM | HASH_BLOBS);
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(MySQLReplicaLoadKey);
+	ctl.entrysize = sizeof(MySQLReplicaLoad);
+	mysql_replica_hash = ShmemInitHash("mysql_fdw replica loads",
+									   MYSQL_MAX_REPLICA_LOADS,
+									   MYSQL_MAX_REPLICA_LOADS,
+									   &ctl, HASH_ELEM | HASH_BLOBS);
+
+	mysql_wait_states = ShmemInitStruct("mysql_fdw wait states",
+										mul_size(mysql_wait_nstates,
+												 sizeof(MySQLWaitState)),
+										&found);
+	if (!found)
+		MemSet(mysql_wait_states, 0,
+			   mul_size(mysql_wait_nstates, sizeof(MySQLWaitState)));
+
+	LWLockRelease(AddinShmemInitLock);
+}
+
+/*
+ * mysql_stat_enabled
+ * 		Are remote queries to be counted in the statistics?
+ */
+bool
+mysql_stat_enabled(void)
+{
+	return mysql_stat_hash != NULL && mysql_stat_track;
+}
+
+/*
+ * mysql_stat_record
+ * 		Count a remote query sent to a foreign server in the statistics
+ *
+ * total_time is the time spent on the query in milliseconds, rows the rows
+ * it fetched or modified and bytes the bytes of the values it fetched.
+ */
+void
+mysql_stat_record(Oid serverid, const char *query, double total_time,
+				  int64 rows, int64 bytes)
+{
+	MySQLStatKey key;
+	MySQLStatEntry *entry;
+
+	if (!mysql_stat_enabled() || query == NULL)
+		return;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dbid = MyDatabaseId;
+	key.serverid = serverid;
+#if PG_VERSION_NUM >= 110000
+	key.queryid = DatumGetUInt64(hash_any_extended((const unsigned char *) query,
+												   strlen(query), 0));
+#else
+	key.queryid = DatumGetUInt32(hash_any((const unsigned char *) query,
+										  strlen(query)));
+#endif
+
+	LWLockAcquire(mysql_stat_shared->lock, LW_SHARED);
+
+	entry = (MySQLStatEntry *) hash_search(mysql_stat_hash, &key, HASH_FIND,
+										   NULL);
+
+	/* A new query needs the exclusive lock to get an entry */
+	if (entry == NULL)
+	{
+		LWLockRelease(mysql_stat_shared->lock);
+		LWLockAcquire(mysql_stat_shared->lock, LW_EXCLUSIVE);
+		entry = mysql_stat_entry_alloc(&key, query);
+	}
+
+	/*
+	 * The key does not tell apart two texts with the same hash, so a query
+	 * whose text is not the one of the entry is left out rather than counted
+	 * as another one.
+	 */
+	if (strncmp(entry->query, query, MYSQL_STAT_QUERY_LEN - 1) != 0)
+	{
+		LWLockRelease(mysql_stat_shared->lock);
+		return;
+	}
+
+	/* The counters of an entry are updated under its spinlock only */
+	{
+		volatile MySQLStatEntry *e = (volatile MySQLStatEntry *) entry;
+
+		SpinLockAcquire(&e->mutex);
+		if (e->calls == 0 || total_time < e->min_time)
+			e->min_time = total_time;
+		if (e->calls == 0 || total_time > e->max_time)
+			e->max_time = total_time;
+		e->calls++;
+		e->total_time += total_time;
+		e->rows += rows;
+		e->bytes += bytes;
+		SpinLockRelease(&e->mutex);
+	}
+
+	LWLockRelease(mysql_stat_shared->lock);
+}
+
+/*
+ * mysql_stat_entry_alloc
+ * 		Get the entry of a remote query, creating it if needed
+ *
+ * The entries of the queries called the least often are dropped when the
+ * hash table is full.  The exclusive lock must be held.
+ */
+static MySQLStatEntry *
+mysql_stat_entry_alloc(MySQLStatKey *key, const char *query)
+{
+	MySQLStatEntry *entry;
+	bool		found;
+
+	/* Another backend may have created it while we waited for the lock */
+	entry = (MySQLStatEntry *) hash_search(mysql_stat_hash, key, HASH_FIND,
+										   NULL);
+	if (entry != NULL)
+		return entry;
+
+	if (hash_get_num_entries(mysql_stat_hash) >= mysql_stat_max)
+		mysql_stat_entry_dealloc();
+
+	entry = (MySQLStatEntry *) hash_search(mysql_stat_hash, key, HASH_ENTER,
+										   &found);
+	Assert(!found);
+
+	SpinLockInit(&entry->mutex);
+	entry->calls = 0;
+	entry->total_time = 0;
+	entry->min_time = 0;
+	entry->max_time = 0;
+	entry->rows = 0;
+	entry->bytes = 0;
+	strlcpy(entry->query, query, MYSQL_STAT_QUERY_LEN);
+
+	return entry;
+}
+
+/*
+ * mysql_stat_entry_dealloc
+ * 		Drop the entries of the queries called the least often
+ *
+ * Dropping a share of the entries at once, rather than one, spares the scan
+ * and sort of the whole hash table to most of the new queries once it is
+ * full.  The exclusive lock must be held, so that the counters cannot change.
+ */
+static void
+mysql_stat_entry_dealloc(void)
+{
+	HASH_SEQ_STATUS scan;
+	MySQLStatEntry **entries;
+	MySQLStatEntry *entry;
+	int			nentries = 0;
+	int			nvictims;
+	int			i;
+
+	entries = (MySQLStatEntry **)
+		palloc(hash_get_num_entries(mysql_stat_hash) *
+			   sizeof(MySQLStatEntry *));
+
+	hash_seq_init(&scan, mysql_stat_hash);
+	while ((entry = (MySQLStatEntry *) hash_seq_search(&scan)) != NULL)
+		entries[nentries++] = entry;
+
+	qsort(entries, nentries, sizeof(MySQLStatEntry *), mysql_stat_entry_cmp);
+
+	nvictims = Max(MYSQL_STAT_DEALLOC_MIN,
+				   nentries * MYSQL_STAT_DEALLOC_PERCENT / 100);
+	nvictims = Min(nvictims, nentries);
+
+	for (i = 0; i < nvictims; i++)
+		hash_search(mysql_stat_hash, &entries[i]->key, HASH_REMOVE, NULL);
+
+	pfree(entries);
+}
+
+/*
+ * mysql_stat_entry_cmp
+ * 		qsort comparator putting the entries called the least often first
+ */
+static int
+mysql_stat_entry_cmp(const void *lhs, const void *rhs)
+{
+	int64		l_calls = (*(MySQLStatEntry *const *) lhs)->calls;
+	int64		r_calls = (*(MySQLStatEntry *const *) rhs)->calls;
+
+	if (l_calls < r_calls)
+		return -1;
+	else if (l_calls > r_calls)
+		return 1;
+	return 0;
+}
+
+/*
+ * mysql_replica_acquire
+ * 		Pick the read replica of a foreign server that the fewest
+ * 		transactions of all sessions read from, and count one more
+ * 		transaction reading from it
+ *
+ * The replicas are the first nreplicas of the server.  Returns the index of
+ * the replica, to be given back to mysql_replica_release at the end of the
+ * transaction, or -1 when the loads cannot be counted, without shared
+ * memory or room for one more replica.
+ */
+int
+mysql_replica_acquire(Oid serverid, int nreplicas)
+{
+	MySQLReplicaLoadKey key;
+	MySQLReplicaLoad *load;
+	int			best = -1;
+	int			best_outstanding = INT_MAX;
+	bool		found;
+	int			i;
+
+	if (mysql_replica_hash == NULL)
+		return -1;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dbid = MyDatabaseId;
+	key.serverid = serverid;
+
+	LWLockAcquire(mysql_stat_shared->replica_lock, LW_EXCLUSIVE);
+
+	/* Sessions start from different replicas, to spread ties among them */
+	for (i = 0; i < nreplicas; i++)
+	{
+		key.replica = (i + MyProcPid) % nreplicas;
+		load = (MySQLReplicaLoad *) hash_search(mysql_replica_hash, &key,
+												HASH_FIND, NULL);
+		if (load == NULL)
+		{
+			best = key.replica;
+			break;
+		}
+		if (load->outstanding < best_outstanding)
+		{
+			best = key.replica;
+			best_outstanding = load->outstanding;
+		}
+	}
+
+	key.replica = best;
+	load = (MySQLReplicaLoad *) hash_search(mysql_replica_hash, &key,
+											HASH_ENTER_NULL, &found);
+	if (load == NULL)
+		best = -1;
+	else
+	{
+		if (!found)
+			load->outstanding = 0;
+		load->outstanding++;
+	}
+
+	LWLockRelease(mysql_stat_shared->replica_lock);
+
+	return best;
+}
+
+/*
+ * mysql_replica_release
+ * 		Count one transaction less reading from a read replica picked by
+ * 		mysql_replica_acquire
+ *
+ * This is used at the end of transactions, including aborted ones, so it
+ * must not throw an error.
+ */
+void
+mysql_replica_release(Oid serverid, int replica)
+{
+	MySQLReplicaLoadKey key;
+	MySQLReplicaLoad *load;
+
+	if (mysql_replica_hash == NULL)
+		return;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dbid = MyDatabaseId;
+	key.serverid = serverid;
+	key.replica = replica;
+
+	LWLockAcquire(mysql_stat_shared->replica_lock, LW_EXCLUSIVE);
+
+	load = (MySQLReplicaLoad *) hash_search(mysql_replica_hash, &key,
+											HASH_FIND, NULL);
+	if (load != NULL && --load->outstanding <= 0)
+		hash_search(mysql_replica_hash, &key, HASH_REMOVE, NULL);
+
+	LWLockRelease(mysql_stat_shared->replica_lock);
+}
+
+/*
+ * mysql_wait_event
+ * 		Wait event to report while waiting on a MySQL connection
+ *
+ * Extensions cannot name their own wait events, so all waits are reported as
+ * the "Extension" event.  What the backend waits for is kept in its shared
+ * wait state, for mysql_fdw_wait_events to tell them apart.  The state is not
+ * cleared once the wait ends, as the wait event of the backend tells whether
+ * it still applies.
+ */
+uint32
+mysql_wait_event(MySQLWaitEvent event)
+{
+	if (mysql_wait_states != NULL && MyBackendId != InvalidBackendId &&
+		MyBackendId <= mysql_wait_nstates)
+	{
+		volatile MySQLWaitState *state = &mysql_wait_states[MyBackendId - 1];
+
+		state->pid = MyProcPid;
+		state->event = event;
+	}
+
+	return PG_WAIT_EXTENSION;
+}
+
+/*
+ * mysql_fdw_wait_events
+ * 		Return what the backends waiting on a MySQL connection wait for
+ *
+ * A backend whose wait event is "Extension" is taken to wait for what it
+ * last waited for on a MySQL connection.
+ */
+Datum
+mysql_fdw_wait_events(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
+
+	if (mysql_wait_states == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("mysql_fdw must be loaded via shared_preload_libraries")));
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	/* Build tuplestore to hold the result rows */
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	for (i = 0; i < mysql_wait_nstates; i++)
+	{
+		volatile MySQLWaitState *state = &mysql_wait_states[i];
+		Datum		values[MYSQL_FDW_WAIT_EVENTS_COLS];
+		bool		nulls[MYSQL_FDW_WAIT_EVENTS_COLS];
+		int			pid = state->pid;
+		MySQLWaitEvent event = state->event;
+		PGPROC	   *proc;
+
+		if (pid == 0)
+			continue;
+
+		proc = BackendPidGetProc(pid);
+		if (proc == NULL || proc->wait_event_info != PG_WAIT_EXTENSION)
+			continue;
+
+		MemSet(nulls, 0, sizeof(nulls));
+		values[0] = Int32GetDatum(pid);
+		values[1] = CStringGetTextDatum(mysql_wait_event_names[event]);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * mysql_fdw_stat_statements
+ * 		Return the statistics of the remote queries
+ *
+ * The name of the foreign server is only known for queries sent from the
+ * current database, and is NULL for the others.
+ */
+Datum
+mysql_fdw_stat_statements(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	HASH_SEQ_STATUS scan;
+	MySQLStatEntry *entry;
+
+	if (mysql_stat_hash == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("mysql_fdw must be loaded via shared_preload_libraries")));
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	/* Build tuplestore to hold the result rows */
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	LWLockAcquire(mysql_stat_shared->lock, LW_SHARED);
+
+	hash_seq_init(&scan, mysql_stat_hash);
+	while ((entry = (MySQLStatEntry *) hash_seq_search(&scan)) != NULL)
+	{
+		Datum		values[MYSQL_FDW_STAT_STATEMENTS_COLS];
+		bool		nulls[MYSQL_FDW_STAT_STATEMENTS_COLS];
+		ForeignServer *server = NULL;
+		MySQLStatEntry tmp;
+
+		/* Copy the counters, so as not to hold the spinlock for long */
+		{
+			volatile MySQLStatEntry *e = (volatile MySQLStatEntry *) entry;
+
+			SpinLockAcquire(&e->mutex);
+			tmp.calls = e->calls;
+			tmp.total_time = e->total_time;
+			tmp.min_time = e->min_time;
+			tmp.max_time = e->max_time;
+			tmp.rows = e->rows;
+			tmp.bytes = e->bytes;
+			SpinLockRelease(&e->mutex);
+		}
+
+		/* Not counted yet by the backend that created it */
+		if (tmp.calls == 0)
+			continue;
+
+		MemSet(values, 0, sizeof(values));
+		MemSet(nulls, 0, sizeof(nulls));
+
+		if (entry->key.dbid == MyDatabaseId &&
+			OidIsValid(entry->key.serverid))
+			server = GetForeignServerExtended(entry->key.serverid,
+											  FSV_MISSING_OK);
+
+		values[0] = ObjectIdGetDatum(entry->key.dbid);
+		if (server)
+			values[1] = CStringGetTextDatum(server->servername);
+		else
+			nulls[1] = true;
+		values[2] = CStringGetTextDatum(entry->query);
+		values[3] = Int64GetDatum(tmp.calls);
+		values[4] = Float8GetDatum(tmp.total_time);
+		values[5] = Float8GetDatum(tmp.min_time);
+		values[6] = Float8GetDatum(tmp.max_time);
+		values[7] = Float8GetDatum(tmp.total_time / tmp.calls);
+		values[8] = Int64GetDatum(tmp.rows);
+		values[9] = Int64GetDatum(tmp.bytes);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	LWLockRelease(mysql_stat_shared->lock);
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * mysql_fdw_stat_statements_reset
+ * 		Discard the statistics of all remote queries
+ */
+Datum
+mysql_fdw_stat_statements_reset(PG_FUNCTION_ARGS)
+{
+	HASH_SEQ_STATUS scan;
+	MySQLStatEntry *entry;
+
+	if (mysql_stat_hash == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("mysql_fdw must be loaded via shared_preload_libraries")));
+
+	LWLockAcquire(mysql_stat_shared->lock, LW_EXCLUSIVE);
+
+	hash_seq_init(&scan, mysql_stat_hash);
+	while ((entry = (MySQLStatEntry *) hash_seq_search(&scan)) != NULL)
+		hash_search(mysql_stat_hash, &entry->key, HASH_REMOVE, NULL);
+
+	LWLockRelease(mysql_stat_shared->lock);
+
+	PG_RETURN_VOID();
+}
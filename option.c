@@ -41,6 +41,10 @@ static struct MySQLFdwOption valid_options[] =
 	/* Connection options */
 	{"host", ForeignServerRelationId},
 	{"port", ForeignServerRelationId},
+	{"socket", ForeignServerRelationId},
+	{"transport", ForeignServerRelationId},
+	{"replicas", ForeignServerRelationId},
+	{"replica_selection", ForeignServerRelationId},
 	{"init_command", ForeignServerRelationId},
 	{"username", UserMappingRelationId},
 	{"password", UserMappingRelationId},
@@ -62,6 +66,24 @@ static struct MySQLFdwOption valid_options[] =
 	{"ssl_ca", ForeignServerRelationId},
 	{"ssl_capath", ForeignServerRelationId},
 	{"ssl_cipher", ForeignServerRelationId},
+	/* scan_mode is available on both server and table */
+	{"scan_mode", ForeignServerRelationId},
+	{"scan_mode", ForeignTableRelationId},
+	/* parallel_workers is available on both server and table */
+	{"parallel_workers", ForeignServerRelationId},
+	{"parallel_workers", ForeignTableRelationId},
+	{"max_prepared_statements", ForeignServerRelationId},
+	{"idle_timeout", ForeignServerRelationId},
+	{"max_connection_lifetime", ForeignServerRelationId},
+	{"transaction_mode", ForeignServerRelationId},
+	{"compression", ForeignServerRelationId},
+	{"compression_level", ForeignServerRelationId},
+	/* rescan_cache is available on both server and table */
+	{"rescan_cache", ForeignServerRelationId},
+	{"rescan_cache", ForeignTableRelationId},
+	/* rescan_batch_size is available on both server and table */
+	{"rescan_batch_size", ForeignServerRelationId},
+	{"rescan_batch_size", ForeignTableRelationId},
 #if PG_VERSION_NUM >= 140000
 	/* truncatable is available on both server and table */
 	{"truncatable", ForeignServerRelationId},
@@ -70,6 +92,11 @@ static struct MySQLFdwOption valid_options[] =
 	{"batch_size", ForeignServerRelationId},
 	{"batch_size", ForeignTableRelationId},
 	{"keep_connections", ForeignServerRelationId},
+	{"parallel_commit", ForeignServerRelationId},
+	{"parallel_abort", ForeignServerRelationId},
+	/* async_capable is available on both server and table */
+	{"async_capable", ForeignServerRelationId},
+	{"async_capable", ForeignTableRelationId},
 #endif
 
 	/* Sentinel */
@@ -152,16 +179,69 @@ mysql_fdw_validator(PG_FUNCTION_ARGS)
 						 errmsg("\"%s\" requires an integer value between 1 to %lu",
 								def->defname, ULONG_MAX)));
 		}
-		else if (strcmp(def->defname, "reconnect") == 0)
+		else if (strcmp(def->defname, "reconnect") == 0 ||
+				 strcmp(def->defname, "rescan_cache") == 0)
 		{
 			/* accept only boolean values */
 			(void) defGetBoolean(def);
 		}
+		else if (strcmp(def->defname, "scan_mode") == 0)
+			(void) mysql_parse_scan_mode(def);
+		else if (strcmp(def->defname, "transaction_mode") == 0)
+			(void) mysql_parse_transaction_mode(def);
+		else if (strcmp(def->defname, "compression") == 0)
+			(void) mysql_parse_compression(def);
+		else if (strcmp(def->defname, "transport") == 0)
+			(void) mysql_parse_transport(def);
+		else if (strcmp(def->defname, "replicas") == 0)
+			(void) mysql_parse_replicas(def);
+		else if (strcmp(def->defname, "replica_selection") == 0)
+			(void) mysql_parse_replica_selection(def);
+		else if (strcmp(def->defname, "compression_level") == 0)
+		{
+			char	   *value = defGetString(def);
+			int			int_val;
+
+			if (!parse_int(value, &int_val, 0, NULL))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("invalid value for integer option \"%s\": %s",
+								def->defname, value)));
+
+			if (int_val < 1 || int_val > MYSQL_MAX_COMPRESSION_LEVEL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("\"%s\" must be an integer value between 1 and %d",
+								def->defname, MYSQL_MAX_COMPRESSION_LEVEL)));
+		}
+		else if (strcmp(def->defname, "parallel_workers") == 0 ||
+				 strcmp(def->defname, "max_prepared_statements") == 0 ||
+				 strcmp(def->defname, "idle_timeout") == 0 ||
+				 strcmp(def->defname, "max_connection_lifetime") == 0 ||
+				 strcmp(def->defname, "rescan_batch_size") == 0)
+		{
+			char	   *value = defGetString(def);
+			int			int_val;
+
+			if (!parse_int(value, &int_val, 0, NULL))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("invalid value for integer option \"%s\": %s",
+								def->defname, value)));
+
+			if (int_val < 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("\"%s\" must be an integer value greater than or equal to zero",
+								def->defname)));
+		}
 #if PG_VERSION_NUM >= 140000
 		if (strcmp(def->defname, "use_remote_estimate") == 0 ||
 			strcmp(def->defname, "truncatable") == 0 ||
 			strcmp(def->defname, "async_capable") == 0 ||
-			strcmp(def->defname, "keep_connections") == 0)
+			strcmp(def->defname, "keep_connections") == 0 ||
+			strcmp(def->defname, "parallel_commit") == 0 ||
+			strcmp(def->defname, "parallel_abort") == 0)
 		{
 			/* these accept only boolean values */
 			(void) defGetBoolean(def);
@@ -255,6 +335,8 @@ mysql_get_options(Oid foreignoid, bool is_foreigntable)
 
 	opt->use_remote_estimate = false;
 	opt->reconnect = false;
+	opt->rescan_cache = false;
+	opt->max_prepared_statements = MYSQL_DEFAULT_PREPARED_STATEMENTS;
 
 	/* Loop through the options */
 	foreach(lc, options)
@@ -264,9 +346,21 @@ mysql_get_options(Oid foreignoid, bool is_foreigntable)
 		if (strcmp(def->defname, "host") == 0)
 			opt->svr_address = defGetString(def);
 
+		if (strcmp(def->defname, "socket") == 0)
+			opt->svr_socket = defGetString(def);
+
+		if (strcmp(def->defname, "transport") == 0)
+			opt->transport = mysql_parse_transport(def);
+
 		if (strcmp(def->defname, "port") == 0)
 			opt->svr_port = atoi(defGetString(def));
 
+		if (strcmp(def->defname, "replicas") == 0)
+			opt->replicas = mysql_parse_replicas(def);
+
+		if (strcmp(def->defname, "replica_selection") == 0)
+			opt->replica_selection = mysql_parse_replica_selection(def);
+
 		if (strcmp(def->defname, "username") == 0)
 			opt->svr_username = defGetString(def);
 
@@ -297,6 +391,9 @@ mysql_get_options(Oid foreignoid, bool is_foreigntable)
 		if (strcmp(def->defname, "reconnect") == 0)
 			opt->reconnect = defGetBoolean(def);
 
+		if (strcmp(def->defname, "rescan_cache") == 0)
+			opt->rescan_cache = defGetBoolean(def);
+
 		if (strcmp(def->defname, "column_name") == 0)
 			opt->column_name = defGetString(def);
 
@@ -314,15 +411,56 @@ mysql_get_options(Oid foreignoid, bool is_foreigntable)
 
 		if (strcmp(def->defname, "ssl_cipher") == 0)
 			opt->ssl_cipher = defGetString(def);
+
+		if (strcmp(def->defname, "scan_mode") == 0)
+			opt->scan_mode = mysql_parse_scan_mode(def);
+
+		if (strcmp(def->defname, "transaction_mode") == 0)
+			opt->transaction_mode = mysql_parse_transaction_mode(def);
+
+		if (strcmp(def->defname, "compression") == 0)
+			opt->compression = mysql_parse_compression(def);
+
+		if (strcmp(def->defname, "compression_level") == 0)
+			(void) parse_int(defGetString(def), &opt->compression_level, 0,
+							 NULL);
+
+		if (strcmp(def->defname, "parallel_workers") == 0)
+			(void) parse_int(defGetString(def), &opt->parallel_workers, 0,
+							 NULL);
+
+		if (strcmp(def->defname, "max_prepared_statements") == 0)
+			(void) parse_int(defGetString(def), &opt->max_prepared_statements,
+							 0, NULL);
+
+		if (strcmp(def->defname, "idle_timeout") == 0)
+			(void) parse_int(defGetString(def), &opt->idle_timeout, 0, NULL);
+
+		if (strcmp(def->defname, "max_connection_lifetime") == 0)
+			(void) parse_int(defGetString(def), &opt->max_connection_lifetime,
+							 0, NULL);
 	}
 
 	/* Default values, if required */
 	if (!opt->svr_address)
 		opt->svr_address = "127.0.0.1";
 
+	/* A socket given on its own is a Unix-domain one */
+	if (opt->transport == MYSQL_TRANSPORT_DEFAULT && opt->svr_socket)
+		opt->transport = MYSQL_TRANSPORT_SOCKET;
+
 	if (!opt->svr_port)
 		opt->svr_port = MYSQL_DEFAULT_SERVER_PORT;
 
+	/* Replicas listen on the port of the server unless told otherwise */
+	foreach(lc, opt->replicas)
+	{
+		MySQLReplica *replica = (MySQLReplica *) lfirst(lc);
+
+		if (!replica->port)
+			replica->port = opt->svr_port;
+	}
+
 	/*
 	 * When we don't have a table name or database name provided in the
 	 * FOREIGN TABLE options, then use a foreign table name as the target
@@ -343,3 +481,194 @@ mysql_get_options(Oid foreignoid, bool is_foreigntable)
 
 	return opt;
 }
+
+/*
+ * Parse the value of the scan_mode option.
+ */
+MySQLScanMode
+mysql_parse_scan_mode(DefElem *def)
+{
+	char	   *value = defGetString(def);
+
+	if (strcmp(value, "cursor") == 0)
+		return MYSQL_SCAN_MODE_CURSOR;
+	if (strcmp(value, "stream") == 0)
+		return MYSQL_SCAN_MODE_STREAM;
+	if (strcmp(value, "buffered") == 0)
+		return MYSQL_SCAN_MODE_BUFFERED;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value for option \"%s\": \"%s\"",
+					def->defname, value),
+			 errhint("Valid values are \"cursor\", \"stream\" and \"buffered\".")));
+
+	return MYSQL_SCAN_MODE_CURSOR;	/* keep compiler quiet */
+}
+
+/*
+ * Parse the value of the transaction_mode option.
+ */
+MySQLTransactionMode
+mysql_parse_transaction_mode(DefElem *def)
+{
+	char	   *value = defGetString(def);
+
+	if (strcmp(value, "transaction") == 0)
+		return MYSQL_TRANSACTION_MODE_TRANSACTION;
+	if (strcmp(value, "autocommit") == 0)
+		return MYSQL_TRANSACTION_MODE_AUTOCOMMIT;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value for option \"%s\": \"%s\"",
+					def->defname, value),
+			 errhint("Valid values are \"transaction\" and \"autocommit\".")));
+
+	return MYSQL_TRANSACTION_MODE_TRANSACTION;	/* keep compiler quiet */
+}
+
+/*
+ * Parse the value of the compression option.
+ */
+MySQLCompression
+mysql_parse_compression(DefElem *def)
+{
+	char	   *value = defGetString(def);
+
+	if (strcmp(value, "off") == 0)
+		return MYSQL_COMPRESSION_OFF;
+	if (strcmp(value, "zlib") == 0)
+		return MYSQL_COMPRESSION_ZLIB;
+	if (strcmp(value, "zstd") == 0)
+		return MYSQL_COMPRESSION_ZSTD;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value for option \"%s\": \"%s\"",
+					def->defname, value),
+			 errhint("Valid values are \"off\", \"zlib\" and \"zstd\".")));
+
+	return MYSQL_COMPRESSION_OFF;	/* keep compiler quiet */
+}
+
+/*
+ * Parse the value of the transport option.
+ */
+MySQLTransport
+mysql_parse_transport(DefElem *def)
+{
+	char	   *value = defGetString(def);
+
+	if (strcmp(value, "tcp") == 0)
+		return MYSQL_TRANSPORT_TCP;
+	if (strcmp(value, "socket") == 0)
+		return MYSQL_TRANSPORT_SOCKET;
+	if (strcmp(value, "pipe") == 0)
+		return MYSQL_TRANSPORT_PIPE;
+	if (strcmp(value, "memory") == 0)
+		return MYSQL_TRANSPORT_MEMORY;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value for option \"%s\": \"%s\"",
+					def->defname, value),
+			 errhint("Valid values are \"tcp\", \"socket\", \"pipe\" and \"memory\".")));
+
+	return MYSQL_TRANSPORT_DEFAULT; /* keep compiler quiet */
+}
+
+/*
+ * Parse the value of the replicas option, a comma-separated list of
+ * host[:port] entries, into a list of MySQLReplica.  An IPv6 address is
+ * written in brackets to be followed by a port.  The port of an entry
+ * without one is left as 0.
+ */
+List *
+mysql_parse_replicas(DefElem *def)
+{
+	char	   *value = defGetString(def);
+	char	   *item = pstrdup(value);
+	List	   *replicas = NIL;
+
+	for (;;)
+	{
+		char	   *next = strchr(item, ',');
+		char	   *end;
+		char	   *port = NULL;
+		bool		invalid = false;
+		MySQLReplica *replica;
+
+		if (next != NULL)
+			*next++ = '\0';
+
+		while (isspace((unsigned char) *item))
+			item++;
+		end = item + strlen(item);
+		while (end > item && isspace((unsigned char) end[-1]))
+			*--end = '\0';
+
+		if (*item == '[')
+		{
+			end = strchr(++item, ']');
+			if (end == NULL || (end[1] != '\0' && end[1] != ':'))
+				invalid = true;
+			else
+			{
+				if (end[1] == ':')
+					port = end + 2;
+				*end = '\0';
+			}
+		}
+		else if ((port = strchr(item, ':')) != NULL)
+		{
+			/* Several colons make an IPv6 address without a port */
+			if (strchr(port + 1, ':') != NULL)
+				port = NULL;
+			else
+				*port++ = '\0';
+		}
+
+		replica = (MySQLReplica *) palloc0(sizeof(MySQLReplica));
+		replica->host = item;
+		if (invalid || *item == '\0' ||
+			(port != NULL &&
+			 (!parse_int(port, &replica->port, 0, NULL) ||
+			  replica->port < 1 || replica->port > 65535)))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("invalid value for option \"%s\": \"%s\"",
+							def->defname, value),
+					 errhint("Valid values are comma-separated lists of host[:port] entries.")));
+
+		replicas = lappend(replicas, replica);
+
+		if (next == NULL)
+			break;
+		item = next;
+	}
+
+	return replicas;
+}
+
+/*
+ * Parse the value of the replica_selection option.
+ */
+MySQLReplicaSelection
+mysql_parse_replica_selection(DefElem *def)
+{
+	char	   *value = defGetString(def);
+
+	if (strcmp(value, "round_robin") == 0)
+		return MYSQL_REPLICA_SELECTION_ROUND_ROBIN;
+	if (strcmp(value, "least_outstanding") == 0)
+		return MYSQL_REPLICA_SELECTION_LEAST_OUTSTANDING;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value for option \"%s\": \"%s\"",
+					def->defname, value),
+			 errhint("Valid values are \"round_robin\" and \"least_outstanding\".")));
+
+	return MYSQL_REPLICA_SELECTION_ROUND_ROBIN; /* keep compiler quiet */
+}
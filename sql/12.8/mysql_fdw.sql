@@ -613,6 +613,20 @@ EXPLAIN VERBOSE
 --Testcase 168:
 SELECT * FROM ft4 WHERE c2 = c1[c2];
 
+-- The statistics of the remote queries need mysql_fdw to be loaded via
+-- shared_preload_libraries, which the regression tests do not do.
+--Testcase 221:
+SELECT attname, atttypid::regtype FROM pg_attribute
+  WHERE attrelid = 'mysql_fdw_stat_statements'::regclass AND attnum > 0
+  ORDER BY attnum;
+--Testcase 222:
+SELECT * FROM mysql_fdw_stat_statements;
+--Testcase 223:
+SELECT mysql_fdw_stat_statements_reset();
+-- So does the state of the waits on MySQL connections.
+--Testcase 224:
+SELECT * FROM mysql_fdw_wait_events();
+
 --Testcase 169:
 DROP FOREIGN TABLE ft1;
 --Testcase 170:
@@ -3650,13 +3650,24 @@ DROP SERVER mysql_svr3 CASCADE;
 -- should be output as invalid connections. Also the server name for
 -- mysql_svr3 should be NULL because the server was dropped.
 --Testcase 797:
-SELECT * FROM mysql_fdw_get_connections() ORDER BY 1;
+SELECT server_name, valid FROM mysql_fdw_get_connections() ORDER BY 1;
 -- The invalid connections get closed in pgfdw_xact_callback during commit.
 COMMIT;
 -- All cached connections were closed while committing above xact, so no
 -- records should be output.
 --Testcase 798:
 SELECT server_name FROM mysql_fdw_get_connections() ORDER BY 1;
+-- The second run of a query finds its statement in the prepared statement
+-- cache of the connection.
+--Testcase 869:
+SELECT 1 FROM ft1 LIMIT 1;
+--Testcase 870:
+SELECT 1 FROM ft1 LIMIT 1;
+--Testcase 871:
+SELECT server_name, stmt_cache_hits > 0 AS hit, stmt_cache_misses > 0 AS miss
+  FROM mysql_fdw_get_connections() ORDER BY 1;
+--Testcase 872:
+SELECT 1 FROM mysql_fdw_disconnect_all();
 
 -- =======================================================================
 -- test mysql_fdw_disconnect and mysql_fdw_disconnect_all functions
@@ -4137,6 +4148,687 @@ DROP TABLE batch_table;
 -- ALTER SERVER mysql_svr OPTIONS (DROP async_capable);
 -- ALTER SERVER mysql_svr2 OPTIONS (DROP async_capable);
 
+-- ===================================================================
+-- test batched parameterized scans
+-- ===================================================================
+-- The outer keys are unsorted and hold NULL, duplicates and keys which are
+-- out of the window or have no remote row.
+--Testcase 873:
+CREATE TABLE rb_outer (k int);
+--Testcase 874:
+INSERT INTO rb_outer VALUES (3), (1), (NULL), (2), (2), (9), (5), (1000), (998),
+  (1001), (2000), (-1), (500), (4), (NULL), (6);
+--Testcase 875:
+CREATE INDEX rb_outer_k ON rb_outer (k);
+--Testcase 876:
+ANALYZE rb_outer;
+--Testcase 877:
+CREATE FOREIGN TABLE ft_rb (
+	c1 int OPTIONS (column_name 'C 1') NOT NULL,
+	c2 int NOT NULL,
+	c3 text
+) SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_post', table_name 'T 1',
+  use_remote_estimate 'true');
+--Testcase 878:
+SET enable_hashjoin TO false;
+--Testcase 879:
+SET enable_mergejoin TO false;
+--Testcase 880:
+SET enable_material TO false;
+-- Remember the results of the unbatched scans.
+--Testcase 881:
+CREATE TEMP TABLE rb_join AS
+SELECT o.k, t.c1, t.c2, t.c3 FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k;
+--Testcase 882:
+CREATE TEMP TABLE rb_rescan AS
+SELECT a.x, (SELECT count(t.c1) FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k
+  WHERE o.k > a.x) AS cnt FROM (VALUES (0), (4), (999)) a(x);
+--Testcase 883:
+ALTER FOREIGN TABLE ft_rb OPTIONS (ADD rescan_batch_size '8');
+--Testcase 884:
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT o.k, t.c1, t.c2, t.c3 FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k;
+-- The batched scan returns the same rows as the unbatched one.
+--Testcase 885:
+SELECT count(*) FROM ((SELECT o.k, t.c1, t.c2, t.c3 FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k)
+  EXCEPT ALL SELECT * FROM rb_join) s;
+--Testcase 886:
+SELECT count(*) FROM (SELECT * FROM rb_join
+  EXCEPT ALL (SELECT o.k, t.c1, t.c2, t.c3 FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k)) s;
+-- The window survives the rescans of the whole join.
+--Testcase 887:
+SELECT count(*) FROM ((SELECT a.x, (SELECT count(t.c1) FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k
+  WHERE o.k > a.x) AS cnt FROM (VALUES (0), (4), (999)) a(x))
+  EXCEPT ALL SELECT * FROM rb_rescan) s;
+--Testcase 888:
+SELECT count(*) FROM (SELECT * FROM rb_rescan
+  EXCEPT ALL (SELECT a.x, (SELECT count(t.c1) FROM rb_outer o LEFT JOIN ft_rb t ON t.c1 = o.k
+  WHERE o.k > a.x) AS cnt FROM (VALUES (0), (4), (999)) a(x))) s;
+-- A join on a column that is not the key of a unique index of the MySQL table
+-- is not batched, and reads the rows of each rescan's key alone.
+--Testcase 1046:
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT o.k, t.c1 FROM rb_outer o LEFT JOIN ft_rb t ON t.c2 = o.k;
+--Testcase 1047:
+SELECT count(*) FROM ((SELECT o.k, t.c1 FROM rb_outer o LEFT JOIN ft_rb t ON t.c2 = o.k)
+  EXCEPT ALL (WITH t AS MATERIALIZED (SELECT * FROM ft_rb)
+  SELECT o.k, t.c1 FROM rb_outer o LEFT JOIN t ON t.c2 = o.k)) s;
+--Testcase 1048:
+SELECT count(*) FROM ((WITH t AS MATERIALIZED (SELECT * FROM ft_rb)
+  SELECT o.k, t.c1 FROM rb_outer o LEFT JOIN t ON t.c2 = o.k)
+  EXCEPT ALL (SELECT o.k, t.c1 FROM rb_outer o LEFT JOIN ft_rb t ON t.c2 = o.k)) s;
+--Testcase 889:
+RESET enable_hashjoin;
+--Testcase 890:
+RESET enable_mergejoin;
+--Testcase 891:
+RESET enable_material;
+--Testcase 892:
+DROP FOREIGN TABLE ft_rb;
+--Testcase 893:
+DROP TABLE rb_outer;
+--Testcase 894:
+DROP TABLE rb_join;
+--Testcase 895:
+DROP TABLE rb_rescan;
+
+
+-- ===================================================================
+-- test rescan cache
+-- ===================================================================
+--Testcase 1049:
+CREATE TABLE rc_outer (i int, x int, n int);
+-- The same parameter values come back, and a rescan may stop before the end
+-- of its result, when its limit is reached.
+--Testcase 1050:
+INSERT INTO rc_outer VALUES (1, 1, 1), (2, 1, 1000), (3, 2, 1000), (4, 1, 3),
+  (5, NULL, 1000), (6, 1, 1000), (7, 2, 1), (8, 2, 1000), (9, NULL, 1000);
+--Testcase 1051:
+CREATE FOREIGN TABLE ft_rc (
+	c1 int OPTIONS (column_name 'C 1') NOT NULL,
+	c2 int NOT NULL,
+	c3 text
+) SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_post', table_name 'T 1');
+-- Remember the results of the uncached scans.  The local condition keeps the
+-- limit from being pushed down, so that it stops the scan.
+--Testcase 1052:
+CREATE TEMP TABLE rc_result AS
+SELECT a.i, (SELECT count(*) FROM (SELECT t.c1 FROM ft_rc t
+  WHERE t.c2 = a.x AND random() >= 0 LIMIT a.n) s) AS cnt
+  FROM rc_outer a;
+--Testcase 1053:
+ALTER FOREIGN TABLE ft_rc OPTIONS (ADD rescan_cache 'true');
+-- A rescan stopped by its limit does not leave its first rows as the result
+-- of its parameter values.
+--Testcase 1054:
+SELECT count(*) FROM ((SELECT a.i, (SELECT count(*) FROM (SELECT t.c1 FROM ft_rc t
+  WHERE t.c2 = a.x AND random() >= 0 LIMIT a.n) s) AS cnt
+  FROM rc_outer a)
+  EXCEPT ALL SELECT * FROM rc_result) s;
+--Testcase 1055:
+SELECT count(*) FROM (SELECT * FROM rc_result
+  EXCEPT ALL (SELECT a.i, (SELECT count(*) FROM (SELECT t.c1 FROM ft_rc t
+  WHERE t.c2 = a.x AND random() >= 0 LIMIT a.n) s) AS cnt
+  FROM rc_outer a)) s;
+--Testcase 1056:
+DROP FOREIGN TABLE ft_rc;
+--Testcase 1057:
+DROP TABLE rc_outer;
+--Testcase 1058:
+DROP TABLE rc_result;
+
+
+-- ===================================================================
+-- test scan modes
+-- ===================================================================
+--Testcase 896:
+CREATE FOREIGN TABLE ft_stream (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3',
+  scan_mode 'stream');
+--Testcase 897:
+CREATE FOREIGN TABLE ft_buffered (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3',
+  scan_mode 'buffered');
+--Testcase 898:
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM ft_stream;
+--Testcase 899:
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM ft_buffered;
+-- Stream and buffered scans return the same rows as a cursor scan.
+--Testcase 900:
+SELECT count(*) FROM (SELECT * FROM ft_stream EXCEPT ALL SELECT * FROM ft4) s;
+--Testcase 901:
+SELECT count(*) FROM (SELECT * FROM ft4 EXCEPT ALL SELECT * FROM ft_stream) s;
+--Testcase 902:
+SELECT count(*) FROM (SELECT * FROM ft_buffered EXCEPT ALL SELECT * FROM ft4) s;
+--Testcase 903:
+SELECT count(*) FROM (SELECT * FROM ft4 EXCEPT ALL SELECT * FROM ft_buffered) s;
+-- A stream scan reads its rows on a connection of its own, while the other
+-- scans of the statement go on using the shared one.
+--Testcase 904:
+SELECT count(*) FROM ft_stream s
+  WHERE s.c2 IS DISTINCT FROM (SELECT c2 FROM ft4 WHERE c1 = s.c1);
+-- Two stream scans of the same join read their rows at the same time, each on
+-- a connection of its own.  The inner one is rescanned for each outer row.
+--Testcase 1074:
+SELECT (SELECT count(*) FROM ft_stream a,
+  LATERAL (SELECT b.c2 FROM ft_stream b WHERE b.c1 = a.c1 OFFSET 0) s
+  WHERE s.c2 = a.c2) = (SELECT count(*) FROM ft4) AS same;
+-- Once the transaction has written to the server, a stream scan reads through
+-- a cursor on the shared connection, so that it sees what was written.
+--Testcase 1013:
+CREATE FOREIGN TABLE ft_stream_empty (c1 int NOT NULL, c2 text)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_post', table_name 'loct_empty',
+  scan_mode 'stream');
+BEGIN;
+--Testcase 1014:
+SELECT * FROM ft_stream_empty;
+--Testcase 1015:
+INSERT INTO ft_empty VALUES (1, 'one');
+--Testcase 1016:
+SELECT * FROM ft_stream_empty;
+ROLLBACK;
+--Testcase 1017:
+SELECT * FROM ft_stream_empty;
+--Testcase 1018:
+DROP FOREIGN TABLE ft_stream_empty;
+--Testcase 905:
+DROP FOREIGN TABLE ft_stream;
+--Testcase 906:
+DROP FOREIGN TABLE ft_buffered;
+
+
+-- ===================================================================
+-- test parallel scans
+-- ===================================================================
+-- Make the transfer of rows costly enough for a parallel scan to win.
+--Testcase 907:
+CREATE SERVER mysql_svr_par FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  fdw_startup_cost '0', fdw_tuple_cost '10');
+--Testcase 908:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_par
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 909:
+CREATE FOREIGN TABLE ft_par (c1 int NOT NULL OPTIONS (column_name 'C 1'),
+  c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_par OPTIONS (dbname 'mysql_fdw_post', table_name 'T 1',
+  parallel_workers '2');
+--Testcase 910:
+SET parallel_setup_cost = 0;
+--Testcase 911:
+SET parallel_tuple_cost = 0;
+--Testcase 912:
+SET max_parallel_workers_per_gather = 2;
+--Testcase 913:
+EXPLAIN (COSTS OFF) SELECT * FROM ft_par;
+--Testcase 914:
+CREATE TEMP TABLE par_rows AS SELECT * FROM ft_par;
+--Testcase 915:
+RESET max_parallel_workers_per_gather;
+--Testcase 916:
+RESET parallel_tuple_cost;
+--Testcase 917:
+RESET parallel_setup_cost;
+-- The ranges read by the processes together cover every row once.
+--Testcase 918:
+SELECT count(*) FROM (SELECT * FROM par_rows EXCEPT ALL
+  SELECT c1, c2, c3 FROM ft1) s;
+--Testcase 919:
+SELECT count(*) FROM (SELECT c1, c2, c3 FROM ft1 EXCEPT ALL
+  SELECT * FROM par_rows) s;
+--Testcase 920:
+DROP TABLE par_rows;
+--Testcase 921:
+DROP FOREIGN TABLE ft_par;
+--Testcase 922:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_par;
+--Testcase 923:
+DROP SERVER mysql_svr_par;
+
+
+-- ===================================================================
+-- test transaction modes
+-- ===================================================================
+--Testcase 924:
+CREATE SERVER mysql_svr_autocommit FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  transaction_mode 'autocommit');
+--Testcase 925:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_autocommit
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 926:
+CREATE FOREIGN TABLE ft_vars_autocommit (variable_name text,
+  variable_value text) SERVER mysql_svr_autocommit
+  OPTIONS (dbname 'performance_schema', table_name 'session_variables');
+--Testcase 927:
+CREATE FOREIGN TABLE ft_vars (variable_name text, variable_value text)
+  SERVER mysql_svr
+  OPTIONS (dbname 'performance_schema', table_name 'session_variables');
+-- A read outside a transaction block runs without a remote transaction with
+-- the autocommit mode, and inside one with the default mode.
+--Testcase 928:
+SELECT variable_value FROM ft_vars_autocommit WHERE variable_name = 'autocommit';
+--Testcase 929:
+SELECT variable_value FROM ft_vars WHERE variable_name = 'autocommit';
+-- A read in a transaction block always runs in a remote transaction.
+BEGIN;
+--Testcase 930:
+SELECT variable_value FROM ft_vars_autocommit WHERE variable_name = 'autocommit';
+COMMIT;
+--Testcase 931:
+SELECT variable_value FROM ft_vars_autocommit WHERE variable_name = 'autocommit';
+-- A read-only transaction makes the remote one read-only through the session's
+-- transaction access mode, so that no START TRANSACTION is sent on its own.
+BEGIN READ ONLY;
+--Testcase 1072:
+SELECT variable_value FROM ft_vars WHERE variable_name = 'transaction_read_only';
+COMMIT;
+--Testcase 1073:
+SELECT variable_value FROM ft_vars WHERE variable_name = 'transaction_read_only';
+--Testcase 932:
+DROP FOREIGN TABLE ft_vars_autocommit;
+--Testcase 933:
+DROP FOREIGN TABLE ft_vars;
+--Testcase 934:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_autocommit;
+--Testcase 935:
+DROP SERVER mysql_svr_autocommit;
+
+
+-- ===================================================================
+-- test parallel commit and abort
+-- ===================================================================
+--Testcase 936:
+CREATE SERVER mysql_svr_pc1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  parallel_commit 'true', parallel_abort 'true');
+--Testcase 937:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_pc1
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 938:
+CREATE SERVER mysql_svr_pc2 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  parallel_commit 'true', parallel_abort 'true');
+--Testcase 939:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_pc2
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 940:
+CREATE FOREIGN TABLE ft_pc1 (c1 int NOT NULL, c2 text)
+  SERVER mysql_svr_pc1
+  OPTIONS (dbname 'mysql_fdw_post', table_name 'loct_empty');
+--Testcase 941:
+CREATE FOREIGN TABLE ft_pc2 (c1 int NOT NULL, c2 text)
+  SERVER mysql_svr_pc2
+  OPTIONS (dbname 'mysql_fdw_post', table_name 'loct_empty');
+-- The remote transactions of both servers are committed together.
+BEGIN;
+--Testcase 942:
+INSERT INTO ft_pc1 VALUES (1, 'one');
+--Testcase 943:
+INSERT INTO ft_pc2 VALUES (2, 'two');
+COMMIT;
+--Testcase 944:
+SELECT * FROM ft_pc1 ORDER BY c1;
+-- A failure on one server rolls back the remote transactions of both.
+BEGIN;
+--Testcase 945:
+INSERT INTO ft_pc1 VALUES (3, 'three');
+--Testcase 946:
+INSERT INTO ft_pc2 VALUES (2, 'two');  -- duplicate key
+ROLLBACK;
+--Testcase 947:
+SELECT * FROM ft_pc1 ORDER BY c1;
+--Testcase 948:
+DELETE FROM ft_pc1;
+--Testcase 949:
+DROP FOREIGN TABLE ft_pc1;
+--Testcase 950:
+DROP FOREIGN TABLE ft_pc2;
+--Testcase 951:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_pc1;
+--Testcase 952:
+DROP SERVER mysql_svr_pc1;
+--Testcase 953:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_pc2;
+--Testcase 954:
+DROP SERVER mysql_svr_pc2;
+
+
+-- ===================================================================
+-- test connection expiry
+-- ===================================================================
+--Testcase 955:
+CREATE SERVER mysql_svr_expire_idle FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  idle_timeout '1');
+--Testcase 956:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_expire_idle
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 957:
+CREATE SERVER mysql_svr_expire_life FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  max_connection_lifetime '1');
+--Testcase 958:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_expire_life
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 959:
+CREATE FOREIGN TABLE ft_expire_idle (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_expire_idle
+  OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+--Testcase 960:
+CREATE FOREIGN TABLE ft_expire_life (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_expire_life
+  OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+--Testcase 961:
+SELECT count(*) FROM (SELECT * FROM ft_expire_idle EXCEPT ALL
+  SELECT * FROM ft4) s;
+--Testcase 962:
+SELECT count(*) FROM (SELECT * FROM ft_expire_life EXCEPT ALL
+  SELECT * FROM ft4) s;
+--Testcase 963:
+SELECT server_name FROM mysql_fdw_get_connections()
+  WHERE server_name LIKE 'mysql_svr_expire%' ORDER BY 1;
+-- Both connections are closed at the end of the first transaction after
+-- they expired.
+--Testcase 964:
+SELECT 1 FROM pg_sleep(1.5);
+--Testcase 965:
+SELECT server_name FROM mysql_fdw_get_connections()
+  WHERE server_name LIKE 'mysql_svr_expire%' ORDER BY 1;
+--Testcase 966:
+DROP FOREIGN TABLE ft_expire_idle;
+--Testcase 967:
+DROP FOREIGN TABLE ft_expire_life;
+--Testcase 968:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_expire_idle;
+--Testcase 969:
+DROP SERVER mysql_svr_expire_idle;
+--Testcase 970:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_expire_life;
+--Testcase 971:
+DROP SERVER mysql_svr_expire_life;
+
+
+-- ===================================================================
+-- test compressed connections
+-- ===================================================================
+--Testcase 972:
+CREATE SERVER mysql_svr_zlib FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  compression 'zlib');
+--Testcase 973:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_zlib
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 974:
+CREATE FOREIGN TABLE ft_zlib (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_zlib OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+--Testcase 975:
+CREATE FOREIGN TABLE ft_status_zlib (variable_name text, variable_value text)
+  SERVER mysql_svr_zlib
+  OPTIONS (dbname 'performance_schema', table_name 'session_status');
+--Testcase 976:
+CREATE FOREIGN TABLE ft_status (variable_name text, variable_value text)
+  SERVER mysql_svr
+  OPTIONS (dbname 'performance_schema', table_name 'session_status');
+-- Only the connection of the server with compression compresses its traffic.
+--Testcase 977:
+SELECT variable_value FROM ft_status_zlib WHERE variable_name = 'Compression';
+--Testcase 978:
+SELECT variable_value FROM ft_status WHERE variable_name = 'Compression';
+-- Rows read through a compressed connection are the same.
+--Testcase 979:
+SELECT count(*) FROM (SELECT * FROM ft_zlib EXCEPT ALL SELECT * FROM ft4) s;
+--Testcase 980:
+SELECT count(*) FROM (SELECT * FROM ft4 EXCEPT ALL SELECT * FROM ft_zlib) s;
+--Testcase 981:
+DROP FOREIGN TABLE ft_zlib;
+--Testcase 982:
+DROP FOREIGN TABLE ft_status_zlib;
+--Testcase 983:
+DROP FOREIGN TABLE ft_status;
+--Testcase 984:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_zlib;
+--Testcase 985:
+DROP SERVER mysql_svr_zlib;
+
+
+-- ===================================================================
+-- test connection transports
+-- ===================================================================
+--Testcase 986:
+CREATE SERVER mysql_svr_tcp FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  transport 'tcp');
+--Testcase 987:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_tcp
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 988:
+CREATE SERVER mysql_svr_socket FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  transport 'socket', socket '/nonexistent/mysqld.sock');
+--Testcase 989:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_socket
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 990:
+CREATE FOREIGN TABLE ft_tcp (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_tcp OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+--Testcase 991:
+CREATE FOREIGN TABLE ft_socket (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_socket OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+-- Rows read through a TCP/IP connection asked for explicitly are the same.
+--Testcase 992:
+SELECT count(*) FROM (SELECT * FROM ft_tcp EXCEPT ALL SELECT * FROM ft4) s;
+--Testcase 993:
+SELECT count(*) FROM (SELECT * FROM ft4 EXCEPT ALL SELECT * FROM ft_tcp) s;
+-- A socket transport connects through the given socket, even with a host
+-- set.  The error code in the error message depends on the platform, so check
+-- that through plpgsql block and give the generic error message.
+--Testcase 994:
+DO
+$$
+BEGIN
+  PERFORM * FROM ft_socket;
+  EXCEPTION WHEN others THEN
+	IF SQLERRM LIKE 'failed to connect to MySQL: %''/nonexistent/mysqld.sock''%' THEN
+	  RAISE NOTICE 'failed to connect to MySQL through socket ''/nonexistent/mysqld.sock''';
+    ELSE
+	  RAISE NOTICE '%', SQLERRM;
+	END IF;
+END;
+$$
+LANGUAGE plpgsql;
+--Testcase 995:
+DROP FOREIGN TABLE ft_tcp;
+--Testcase 996:
+DROP FOREIGN TABLE ft_socket;
+--Testcase 997:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_tcp;
+--Testcase 998:
+DROP SERVER mysql_svr_tcp;
+--Testcase 999:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_socket;
+--Testcase 1000:
+DROP SERVER mysql_svr_socket;
+
+
+-- ===================================================================
+-- test read replicas
+-- ===================================================================
+-- The server itself stands in for its read replica.
+--Testcase 1001:
+CREATE SERVER mysql_svr_replica FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT,
+  replicas :MYSQL_HOST);
+--Testcase 1002:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_replica
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 1003:
+CREATE FOREIGN TABLE ft_replica (c1 int NOT NULL, c2 text)
+  SERVER mysql_svr_replica
+  OPTIONS (dbname 'mysql_fdw_post', table_name 'loct_empty');
+-- Reads go to a connection to the replica.
+BEGIN;
+--Testcase 1004:
+SELECT * FROM ft_replica ORDER BY c1;
+--Testcase 1005:
+SELECT server_name FROM mysql_fdw_get_connections()
+  WHERE server_name = 'mysql_svr_replica';
+-- A write goes to a connection to the primary, as do the reads after it, which
+-- see what it wrote.
+--Testcase 1006:
+INSERT INTO ft_replica VALUES (1, 'one');
+--Testcase 1007:
+SELECT server_name FROM mysql_fdw_get_connections()
+  WHERE server_name = 'mysql_svr_replica';
+--Testcase 1008:
+SELECT * FROM ft_replica ORDER BY c1;
+ROLLBACK;
+--Testcase 1009:
+SELECT * FROM ft_replica ORDER BY c1;
+--Testcase 1010:
+DROP FOREIGN TABLE ft_replica;
+--Testcase 1011:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_replica;
+--Testcase 1012:
+DROP SERVER mysql_svr_replica;
+
+
+-- ===================================================================
+-- test prepared statement cache
+-- ===================================================================
+--Testcase 1019:
+CREATE SERVER mysql_svr_stmt FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT);
+--Testcase 1020:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_stmt
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 1021:
+CREATE FOREIGN TABLE ft_stmt (c1 int NOT NULL OPTIONS (column_name 'C 1'),
+  c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_stmt OPTIONS (dbname 'mysql_fdw_post', table_name 'T 1');
+-- A scan stopping before its last row leaves its cursor open on the server,
+-- which is closed before the statement is run again.
+--Testcase 1022:
+SELECT EXISTS (SELECT 1 FROM ft_stmt WHERE c1 > 0);
+--Testcase 1023:
+SELECT EXISTS (SELECT 1 FROM ft_stmt WHERE c1 > 0);
+-- A scan reading all of its rows gives its statement back as is.
+--Testcase 1024:
+SELECT count(*) FROM (SELECT * FROM ft_stmt EXCEPT ALL
+  SELECT c1, c2, c3 FROM ft1) s;
+--Testcase 1025:
+SELECT count(*) FROM (SELECT * FROM ft_stmt EXCEPT ALL
+  SELECT c1, c2, c3 FROM ft1) s;
+-- Each query missed the cache once, and found its statement the second time.
+--Testcase 1026:
+SELECT stmt_cache_hits, stmt_cache_misses FROM mysql_fdw_get_connections()
+  WHERE server_name = 'mysql_svr_stmt';
+--Testcase 1027:
+DROP FOREIGN TABLE ft_stmt;
+--Testcase 1028:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_stmt;
+--Testcase 1029:
+DROP SERVER mysql_svr_stmt;
+
+
+-- ===================================================================
+-- test session variables
+-- ===================================================================
+--Testcase 1030:
+CREATE SERVER mysql_svr_session FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT);
+--Testcase 1031:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_session
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 1032:
+CREATE FOREIGN TABLE ft_session_t3 (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_session OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3');
+--Testcase 1033:
+CREATE FOREIGN TABLE ft_session_vars (variable_name text, variable_value text)
+  SERVER mysql_svr_session
+  OPTIONS (dbname 'performance_schema', table_name 'session_variables');
+--Testcase 1034:
+CREATE FOREIGN TABLE ft_session_status (variable_name text,
+  variable_value text) SERVER mysql_svr_session
+  OPTIONS (dbname 'performance_schema', table_name 'session_status');
+-- Planning, scans and modifies all use the same sql_mode.
+--Testcase 1035:
+SELECT variable_value FROM ft_session_vars WHERE variable_name = 'sql_mode';
+-- Once set, session variables are not sent again by later statements.
+BEGIN;
+--Testcase 1036:
+CREATE TEMP TABLE set_counts AS SELECT variable_value FROM ft_session_status
+  WHERE variable_name = 'Com_set_option';
+--Testcase 1037:
+SELECT count(*) FROM (SELECT * FROM ft_session_t3 EXCEPT ALL
+  SELECT * FROM ft_session_t3) s;
+--Testcase 1038:
+INSERT INTO set_counts SELECT variable_value FROM ft_session_status
+  WHERE variable_name = 'Com_set_option';
+--Testcase 1039:
+SELECT count(*), count(DISTINCT variable_value) FROM set_counts;
+COMMIT;
+--Testcase 1040:
+DROP TABLE set_counts;
+--Testcase 1041:
+DROP FOREIGN TABLE ft_session_t3;
+--Testcase 1042:
+DROP FOREIGN TABLE ft_session_vars;
+--Testcase 1043:
+DROP FOREIGN TABLE ft_session_status;
+--Testcase 1044:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_session;
+--Testcase 1045:
+DROP SERVER mysql_svr_session;
+
+
+-- ===================================================================
+-- test remote work shown by EXPLAIN ANALYZE
+-- ===================================================================
+--Testcase 1059:
+CREATE SERVER mysql_svr_instr FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS (host :MYSQL_HOST, port :MYSQL_PORT);
+--Testcase 1060:
+CREATE USER MAPPING FOR PUBLIC SERVER mysql_svr_instr
+  OPTIONS (username :MYSQL_USER_NAME, password :MYSQL_PASS);
+--Testcase 1061:
+CREATE FOREIGN TABLE ft_instr (c1 int NOT NULL, c2 int NOT NULL, c3 text)
+  SERVER mysql_svr_instr OPTIONS (dbname 'mysql_fdw_post', table_name 'T 3',
+  fetch_size '2');
+--Testcase 1062:
+CREATE FOREIGN TABLE ft_instr_ins (c1 int NOT NULL, c2 text)
+  SERVER mysql_svr_instr OPTIONS (dbname 'mysql_fdw_post',
+  table_name 'loct_empty');
+-- The cursor asks for the rows two at a time.  The statement is prepared
+-- once for the connection, and found in its cache by the second scan.
+--Testcase 1063:
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+SELECT c3 FROM ft_instr WHERE c1 <= 7;
+--Testcase 1064:
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+SELECT c3 FROM ft_instr WHERE c1 <= 7;
+-- Each row inserted is sent on its own.
+BEGIN;
+--Testcase 1065:
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+INSERT INTO ft_instr_ins VALUES (1, 'one'), (2, 'two');
+-- Rows inserted in a batch are sent at once, by a statement of their own.
+--Testcase 1066:
+ALTER FOREIGN TABLE ft_instr_ins OPTIONS (ADD batch_size '5');
+--Testcase 1067:
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+INSERT INTO ft_instr_ins SELECT g, 'x' FROM generate_series(3, 7) g;
+ROLLBACK;
+--Testcase 1068:
+DROP FOREIGN TABLE ft_instr;
+--Testcase 1069:
+DROP FOREIGN TABLE ft_instr_ins;
+--Testcase 1070:
+DROP USER MAPPING FOR PUBLIC SERVER mysql_svr_instr;
+--Testcase 1071:
+DROP SERVER mysql_svr_instr;
+
+
 -- ===================================================================
 -- test invalid server and foreign table options
 -- ===================================================================
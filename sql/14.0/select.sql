@@ -561,6 +561,94 @@ SELECT c1, c2, c3 FROM f_test_tbl1 WHERE pg_catalog.timeofday() IS NOT NULL
 SELECT c1, c2, c3 FROM f_test_tbl1 WHERE pg_catalog.timeofday() IS NOT NULL
   ORDER BY 1 limit 5;
 
+-- Values of varchar and bpchar columns are taken as fetched, neither padded
+-- nor checked against the length of the local column.
+--Testcase 170:
+CREATE FOREIGN TABLE f_test_tbl2_typmod (c1 INTEGER, c2 VARCHAR(5), c3 CHAR(6))
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_regress', table_name 'test_tbl2');
+--Testcase 171:
+SELECT c1, c2, c3 FROM f_test_tbl2_typmod WHERE c1 IN (30, 40) ORDER BY c1;
+--Testcase 172:
+SELECT c1, c3 FROM f_test_tbl2_typmod WHERE c1 = 10;
+--Testcase 173:
+SELECT c2 FROM f_test_tbl2_typmod WHERE c1 = 10;
+--Testcase 174:
+SELECT c3 FROM f_test_tbl2_typmod WHERE c1 = 20;
+--Testcase 175:
+DROP FOREIGN TABLE f_test_tbl2_typmod;
+
+-- Integer, floating point, boolean and temporal columns are converted from
+-- their binary form, with the checks and rounding of the input functions.
+--Testcase 176:
+CREATE FOREIGN TABLE f_native_types (id int, c1 int2, c2 int8, c3 float4,
+  c4 float8, c5 bool, c6 date, c7 time(2), c8 timestamp(0))
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_regress', table_name 'native_types');
+--Testcase 177:
+SELECT id, c1, c3, c4, c5, c6 FROM f_native_types WHERE id IN (1, 2) ORDER BY id;
+--Testcase 178:
+SELECT id, c7, c8 FROM f_native_types WHERE id IN (1, 2) ORDER BY id;
+--Testcase 179:
+SELECT c1, c2, c3, c4, c6, c7, c8, id FROM f_native_types WHERE id = 3;
+--Testcase 180:
+SELECT c2 FROM f_native_types WHERE id = 1;
+--Testcase 181:
+SELECT c2 FROM f_native_types WHERE id = 2;
+--Testcase 182:
+SELECT c5 FROM f_native_types WHERE id = 3;
+--Testcase 183:
+DROP FOREIGN TABLE f_native_types;
+
+-- The conversion of each column is resolved once per scan and kept across
+-- rescans, whatever the order of the local columns and with a dropped one.
+--Testcase 184:
+CREATE FOREIGN TABLE f_test_tbl1_cols (c8 SMALLINT, dropped INTEGER,
+  c5 pg_catalog.Date, c3 CHAR(9), c1 INTEGER)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_regress', table_name 'test_tbl1');
+--Testcase 185:
+ALTER FOREIGN TABLE f_test_tbl1_cols DROP COLUMN dropped;
+--Testcase 186:
+SELECT t.k, f.* FROM (VALUES (200), (100), (200)) t(k),
+  LATERAL (SELECT * FROM f_test_tbl1_cols WHERE c1 = t.k OFFSET 0) f
+  ORDER BY t.k;
+--Testcase 187:
+DROP FOREIGN TABLE f_test_tbl1_cols;
+
+-- Rows kept by a local sort outlive the per-row memory they were converted in.
+--Testcase 188:
+SELECT c1, c2, c3 FROM (SELECT * FROM f_test_tbl1 OFFSET 0) s
+  ORDER BY c3, c1;
+
+-- A value longer than the bind buffer sized from the column metadata, here a
+-- JSON document of more than MAXDATALEN bytes, is fetched again in full.
+--Testcase 189:
+CREATE FOREIGN TABLE f_long_json (id int, j text)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_regress', table_name 'long_json');
+--Testcase 190:
+WITH d AS MATERIALIZED (SELECT id, j FROM f_long_json)
+  SELECT id, length(j), md5(j), left(j, 5) FROM d ORDER BY id;
+--Testcase 191:
+DROP FOREIGN TABLE f_long_json;
+
+-- Whole-row references are formed from the virtual tuples of the scan, in a
+-- plain scan and in a join pushed down to the remote server.
+--Testcase 192:
+SELECT t FROM f_test_tbl1 t WHERE c1 IN (100, 200) ORDER BY c1;
+--Testcase 193:
+SELECT t1, t2.c2 FROM f_test_tbl1 t1 JOIN f_test_tbl2 t2 ON t1.c8 = t2.c1
+  WHERE t1.c1 = 100;
+
+-- Text and binary values above MYSQL_LOB_CHUNK_SIZE are assembled from several
+-- chunks.
+--Testcase 194:
+CREATE FOREIGN TABLE f_long_lobs (id int, t text, b bytea)
+  SERVER mysql_svr OPTIONS (dbname 'mysql_fdw_regress', table_name 'long_lobs');
+--Testcase 195:
+WITH d AS MATERIALIZED (SELECT id, t, b FROM f_long_lobs)
+  SELECT id, length(t), md5(t), length(b), md5(b) FROM d ORDER BY id;
+--Testcase 196:
+DROP FOREIGN TABLE f_long_lobs;
+
+
 -- Cleanup
 --Testcase 99:
 DROP TABLE l_test_tbl1;
@@ -233,6 +233,339 @@ ALTER SERVER reconnect1 OPTIONS ( SET reconnect 'abc1' );
 -- Cleanup reconnect option test objects.
 DROP SERVER reconnect1;
 
+-- Support for scan_mode option at server and table level.
+--Testcase 42:
+CREATE SERVER scanmode1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( scan_mode 'stream' );
+
+--Testcase 43:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'scanmode1'
+  AND srvoptions @> array['scan_mode=stream'];
+
+--Testcase 44:
+CREATE FOREIGN TABLE scanmode_tbl (c1 int) SERVER scanmode1
+  OPTIONS( scan_mode 'buffered' );
+
+--Testcase 45:
+SELECT count(*)
+  FROM pg_foreign_table
+  WHERE ftoptions @> array['scan_mode=buffered'];
+
+-- Negative test case for scan_mode option, should error out.
+--Testcase 46:
+ALTER SERVER scanmode1 OPTIONS ( SET scan_mode 'fast' );
+
+-- Cleanup scan_mode option test objects.
+--Testcase 47:
+DROP FOREIGN TABLE scanmode_tbl;
+--Testcase 48:
+DROP SERVER scanmode1;
+
+-- Support for async_capable option at server and table level.
+--Testcase 97:
+CREATE SERVER async1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( async_capable 'true' );
+
+--Testcase 98:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'async1'
+  AND srvoptions @> array['async_capable=true'];
+
+--Testcase 99:
+CREATE FOREIGN TABLE async_tbl (c1 int) SERVER async1
+  OPTIONS( async_capable 'false' );
+
+--Testcase 100:
+SELECT count(*)
+  FROM pg_foreign_table
+  WHERE ftoptions @> array['async_capable=false'];
+
+-- Negative test case for async_capable option, should error out.
+--Testcase 101:
+ALTER SERVER async1 OPTIONS ( SET async_capable 'abc1' );
+
+-- Cleanup async_capable option test objects.
+--Testcase 102:
+DROP FOREIGN TABLE async_tbl;
+--Testcase 103:
+DROP SERVER async1;
+
+-- Support for parallel_workers option at server and table level.
+--Testcase 49:
+CREATE SERVER parallel1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( parallel_workers '2' );
+
+--Testcase 50:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'parallel1'
+  AND srvoptions @> array['parallel_workers=2'];
+
+--Testcase 51:
+CREATE FOREIGN TABLE parallel_tbl (c1 int) SERVER parallel1
+  OPTIONS( parallel_workers '4' );
+
+--Testcase 52:
+SELECT count(*)
+  FROM pg_foreign_table
+  WHERE ftoptions @> array['parallel_workers=4'];
+
+-- Negative test case for parallel_workers option, should error out.
+--Testcase 53:
+ALTER SERVER parallel1 OPTIONS ( SET parallel_workers '-1' );
+
+-- Cleanup parallel_workers option test objects.
+--Testcase 54:
+DROP FOREIGN TABLE parallel_tbl;
+--Testcase 55:
+DROP SERVER parallel1;
+
+-- Support for max_prepared_statements option at server level.
+--Testcase 104:
+CREATE SERVER stmtcache1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( max_prepared_statements '10' );
+
+--Testcase 105:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'stmtcache1'
+  AND srvoptions @> array['max_prepared_statements=10'];
+
+-- Negative test cases for max_prepared_statements option, should error out.
+--Testcase 106:
+ALTER SERVER stmtcache1 OPTIONS ( SET max_prepared_statements '-1' );
+--Testcase 107:
+ALTER SERVER stmtcache1 OPTIONS ( SET max_prepared_statements 'abc' );
+
+-- Cleanup max_prepared_statements option test objects.
+--Testcase 108:
+DROP SERVER stmtcache1;
+
+-- Support for rescan_batch_size option at server and table level.
+--Testcase 109:
+CREATE SERVER rescan1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( rescan_batch_size '100' );
+
+--Testcase 110:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'rescan1'
+  AND srvoptions @> array['rescan_batch_size=100'];
+
+--Testcase 111:
+CREATE FOREIGN TABLE rescan_tbl (c1 int) SERVER rescan1
+  OPTIONS( rescan_batch_size '10' );
+
+--Testcase 112:
+SELECT count(*)
+  FROM pg_foreign_table
+  WHERE ftoptions @> array['rescan_batch_size=10'];
+
+-- Negative test cases for rescan_batch_size option, should error out.
+--Testcase 113:
+ALTER SERVER rescan1 OPTIONS ( SET rescan_batch_size '-1' );
+--Testcase 114:
+ALTER FOREIGN TABLE rescan_tbl OPTIONS ( SET rescan_batch_size 'abc' );
+
+-- Cleanup rescan_batch_size option test objects.
+--Testcase 115:
+DROP FOREIGN TABLE rescan_tbl;
+--Testcase 116:
+DROP SERVER rescan1;
+
+-- Support for rescan_cache option at server and table level.
+--Testcase 117:
+CREATE SERVER rescancache1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( rescan_cache 'true' );
+
+--Testcase 118:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'rescancache1'
+  AND srvoptions @> array['rescan_cache=true'];
+
+--Testcase 119:
+CREATE FOREIGN TABLE rescancache_tbl (c1 int) SERVER rescancache1
+  OPTIONS( rescan_cache 'false' );
+
+--Testcase 120:
+SELECT count(*)
+  FROM pg_foreign_table
+  WHERE ftoptions @> array['rescan_cache=false'];
+
+-- Negative test case for rescan_cache option, should error out.
+--Testcase 121:
+ALTER SERVER rescancache1 OPTIONS ( SET rescan_cache 'abc1' );
+
+-- Cleanup rescan_cache option test objects.
+--Testcase 122:
+DROP FOREIGN TABLE rescancache_tbl;
+--Testcase 123:
+DROP SERVER rescancache1;
+
+-- Support for transaction_mode option at server level.
+--Testcase 56:
+CREATE SERVER txnmode1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( transaction_mode 'autocommit' );
+
+--Testcase 57:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'txnmode1'
+  AND srvoptions @> array['transaction_mode=autocommit'];
+
+--Testcase 58:
+ALTER SERVER txnmode1 OPTIONS ( SET transaction_mode 'transaction' );
+
+-- Negative test cases for transaction_mode option, should error out.
+--Testcase 59:
+ALTER SERVER txnmode1 OPTIONS ( SET transaction_mode 'none' );
+
+-- Cleanup transaction_mode option test objects.
+--Testcase 60:
+DROP SERVER txnmode1;
+
+-- Support for parallel_commit and parallel_abort options at server level.
+--Testcase 61:
+CREATE SERVER parcommit1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( parallel_commit 'true', parallel_abort 'true' );
+
+--Testcase 62:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'parcommit1'
+  AND srvoptions @> array['parallel_commit=true', 'parallel_abort=true'];
+
+-- Negative test cases for parallel_commit and parallel_abort options, should
+-- error out.
+--Testcase 63:
+ALTER SERVER parcommit1 OPTIONS ( SET parallel_commit 'abc1' );
+--Testcase 64:
+ALTER SERVER parcommit1 OPTIONS ( SET parallel_abort 'abc1' );
+
+-- Cleanup parallel_commit and parallel_abort option test objects.
+--Testcase 65:
+DROP SERVER parcommit1;
+
+-- Support for idle_timeout and max_connection_lifetime options at server
+-- level.
+--Testcase 66:
+CREATE SERVER lifetime1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( idle_timeout '60', max_connection_lifetime '3600' );
+
+--Testcase 67:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'lifetime1'
+  AND srvoptions @> array['idle_timeout=60', 'max_connection_lifetime=3600'];
+
+-- Negative test cases for idle_timeout and max_connection_lifetime options,
+-- should error out.
+--Testcase 68:
+ALTER SERVER lifetime1 OPTIONS ( SET idle_timeout '-1' );
+--Testcase 69:
+ALTER SERVER lifetime1 OPTIONS ( SET max_connection_lifetime 'abc' );
+
+-- Cleanup idle_timeout and max_connection_lifetime option test objects.
+--Testcase 70:
+DROP SERVER lifetime1;
+
+-- Support for compression and compression_level options at server level.
+--Testcase 71:
+CREATE SERVER compress1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( compression 'zstd', compression_level '5' );
+
+--Testcase 72:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'compress1'
+  AND srvoptions @> array['compression=zstd', 'compression_level=5'];
+
+--Testcase 73:
+ALTER SERVER compress1 OPTIONS ( SET compression 'zlib' );
+--Testcase 74:
+ALTER SERVER compress1 OPTIONS ( SET compression 'off' );
+
+-- Negative test cases for compression and compression_level options, should
+-- error out.
+--Testcase 75:
+ALTER SERVER compress1 OPTIONS ( SET compression 'lz4' );
+--Testcase 76:
+ALTER SERVER compress1 OPTIONS ( SET compression_level '0' );
+--Testcase 77:
+ALTER SERVER compress1 OPTIONS ( SET compression_level '23' );
+--Testcase 78:
+ALTER SERVER compress1 OPTIONS ( SET compression_level 'abc' );
+
+-- Cleanup compression option test objects.
+--Testcase 79:
+DROP SERVER compress1;
+
+-- Support for socket and transport options at server level.
+--Testcase 80:
+CREATE SERVER socket1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( socket '/var/run/mysqld/mysqld.sock', transport 'socket' );
+
+--Testcase 81:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'socket1'
+  AND srvoptions @> array['socket=/var/run/mysqld/mysqld.sock',
+                          'transport=socket'];
+
+--Testcase 82:
+ALTER SERVER socket1 OPTIONS ( SET transport 'tcp' );
+--Testcase 83:
+ALTER SERVER socket1 OPTIONS ( SET transport 'pipe' );
+--Testcase 84:
+ALTER SERVER socket1 OPTIONS ( SET transport 'memory' );
+
+-- Negative test case for transport option, should error out.
+--Testcase 85:
+ALTER SERVER socket1 OPTIONS ( SET transport 'udp' );
+
+-- Cleanup socket and transport option test objects.
+--Testcase 86:
+DROP SERVER socket1;
+
+-- Support for replicas and replica_selection options at server level.
+--Testcase 87:
+CREATE SERVER replica1 FOREIGN DATA WRAPPER mysql_fdw
+  OPTIONS( host '10.0.0.1', replicas '10.0.0.2, 10.0.0.3:3307',
+           replica_selection 'least_outstanding' );
+
+--Testcase 88:
+SELECT count(*)
+  FROM pg_foreign_server
+  WHERE srvname = 'replica1'
+  AND srvoptions @> array['replicas=10.0.0.2, 10.0.0.3:3307',
+                          'replica_selection=least_outstanding'];
+
+--Testcase 89:
+ALTER SERVER replica1 OPTIONS ( SET replicas '[::1]:3307,fe80::1' );
+--Testcase 90:
+ALTER SERVER replica1 OPTIONS ( SET replica_selection 'round_robin' );
+
+-- Negative test cases for replicas and replica_selection options, should
+-- error out.
+--Testcase 91:
+ALTER SERVER replica1 OPTIONS ( SET replicas '' );
+--Testcase 92:
+ALTER SERVER replica1 OPTIONS ( SET replicas '10.0.0.2,,10.0.0.3' );
+--Testcase 93:
+ALTER SERVER replica1 OPTIONS ( SET replicas '10.0.0.2:0' );
+--Testcase 94:
+ALTER SERVER replica1 OPTIONS ( SET replicas '[::1' );
+--Testcase 95:
+ALTER SERVER replica1 OPTIONS ( SET replica_selection 'random' );
+
+-- Cleanup replicas and replica_selection option test objects.
+--Testcase 96:
+DROP SERVER replica1;
+
 -- Cleanup
 --Testcase 41:
 DROP EXTENSION mysql_fdw;